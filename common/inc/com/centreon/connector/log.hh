@@ -31,6 +31,7 @@ CCC_BEGIN();
 class log {
  private:
   std::shared_ptr<spdlog::logger> _core_log;
+  bool _on_stderr;
   log();
   ~log();
 
@@ -40,6 +41,7 @@ class log {
   void set_level(spdlog::level::level_enum level);
   void switch_to_stdout();
   void switch_to_file(std::string const& filename);
+  bool is_on_stderr() const noexcept;
 
   static std::shared_ptr<spdlog::logger> core();
 };
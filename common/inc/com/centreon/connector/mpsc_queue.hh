@@ -0,0 +1,128 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#ifndef CCC_MPSC_QUEUE_HH
+#define CCC_MPSC_QUEUE_HH
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include "com/centreon/connector/namespace.hh"
+
+CCC_BEGIN()
+
+/**
+ *  @class mpsc_queue mpsc_queue.hh "com/centreon/connector/mpsc_queue.hh"
+ *  @brief Lock-free multiple producers, single consumer queue.
+ *
+ *  Producers push elements on an atomic stack. The consumer takes the
+ *  whole stack at once and processes it in push order.
+ */
+template <typename T>
+class mpsc_queue {
+  struct node {
+    T value;
+    node* next;
+  };
+
+  std::atomic<node*> _head;
+
+ public:
+  mpsc_queue() : _head(nullptr) {}
+  mpsc_queue(mpsc_queue const& q) = delete;
+  mpsc_queue& operator=(mpsc_queue const& q) = delete;
+
+  /**
+   *  Destructor. Remaining elements are destroyed.
+   */
+  ~mpsc_queue() noexcept {
+    node* n(_head.exchange(nullptr));
+    while (n) {
+      node* next(n->next);
+      delete n;
+      n = next;
+    }
+  }
+
+  /**
+   *  Process all queued elements. Must only be called by the consumer.
+   *
+   *  @param[in] f Callable invoked on each element, in push order. It
+   *               must not throw.
+   *
+   *  @return Number of processed elements.
+   */
+  template <typename F>
+  size_t consume(F f) {
+    // Take the stack and reverse it.
+    node* n(_head.exchange(nullptr, std::memory_order_acquire));
+    node* fifo(nullptr);
+    while (n) {
+      node* next(n->next);
+      n->next = fifo;
+      fifo = n;
+      n = next;
+    }
+
+    // Process elements.
+    size_t retval(0);
+    while (fifo) {
+      node* next(fifo->next);
+      f(std::move(fifo->value));
+      delete fifo;
+      fifo = next;
+      ++retval;
+    }
+    return retval;
+  }
+
+  /**
+   *  Check if queue is empty.
+   *
+   *  @return true if no element is queued.
+   */
+  bool empty() const noexcept {
+    return !_head.load(std::memory_order_relaxed);
+  }
+
+  /**
+   *  Queue an element. Can be called by any thread.
+   *
+   *  @param[in] value Element.
+   *
+   *  @return true if queue was empty, ie. the consumer might need to be
+   *          woken up.
+   */
+  bool push(T&& value) {
+    return _push(new node{std::move(value), nullptr});
+  }
+
+ private:
+  bool _push(node* n) noexcept {
+    n->next = _head.load(std::memory_order_relaxed);
+    while (!_head.compare_exchange_weak(n->next, n, std::memory_order_release,
+                                        std::memory_order_relaxed))
+      ;
+    return !n->next;
+  }
+};
+
+CCC_END()
+
+#endif  // !CCC_MPSC_QUEUE_HH
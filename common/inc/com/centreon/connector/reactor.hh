@@ -0,0 +1,103 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#ifndef CCC_REACTOR_HH
+#define CCC_REACTOR_HH
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "com/centreon/connector/namespace.hh"
+#include "com/centreon/connector/timer_wheel.hh"
+#ifdef WITH_IO_URING
+#include "com/centreon/connector/uring.hh"
+#endif  // WITH_IO_URING
+#include "com/centreon/handle.hh"
+#include "com/centreon/handle_listener.hh"
+#include "com/centreon/task_manager.hh"
+#include "com/centreon/unordered_hash.hh"
+
+CCC_BEGIN()
+
+/**
+ *  @class reactor reactor.hh "com/centreon/connector/reactor.hh"
+ *  @brief epoll-based handle multiplexer.
+ *
+ *  Monitor handles with a level-triggered epoll instance and run the
+ *  tasks of the linked task manager and the timers of the linked timer
+ *  wheel. The read/write interest of a
+ *  handle is kept registered in the kernel: listeners are only asked
+ *  again after the handle got an event or when update() is called,
+ *  not on every iteration.
+ *
+ *  When built with io_uring support, poll requests are submitted in
+ *  batch with the wait for events, saving one system call per
+ *  interest change. epoll is used if the kernel cannot run io_uring.
+ */
+class reactor {
+  struct entry {
+    uint32_t events;
+    handle* h;
+    handle_listener* hl;
+    bool is_dirty;
+    bool is_polled;
+    bool is_removed;
+    uint64_t poll_id;
+  };
+
+  std::vector<entry*> _dirty;
+  int _epoll_fd;
+  std::vector<std::unique_ptr<entry>> _graveyard;
+  umap<handle*, std::unique_ptr<entry>> _handles;
+  task_manager* _task_manager;
+  timer_wheel* _timer_wheel;
+  std::vector<entry*> _unpolled;
+#ifdef WITH_IO_URING
+  std::vector<uring::completion> _completions;
+  uint64_t _next_poll_id;
+  umap<uint64_t, entry*> _polls;
+  std::unique_ptr<uring> _uring;
+#endif  // WITH_IO_URING
+
+  void _dispatch(entry* e, uint32_t revents);
+  void _epoll_multiplex();
+  void _mark_dirty(entry* e);
+  void _refresh();
+  void _release(umap<handle*, std::unique_ptr<entry>>::iterator it);
+#ifdef WITH_IO_URING
+  void _uring_multiplex();
+  void _uring_update(entry* e);
+#endif  // WITH_IO_URING
+  int _wait_timeout() const;
+
+ public:
+  reactor(task_manager* tm = nullptr, timer_wheel* tw = nullptr);
+  reactor(reactor const& r) = delete;
+  virtual ~reactor() noexcept;
+  reactor& operator=(reactor const& r) = delete;
+  void add(handle* h, handle_listener* hl);
+  void multiplex();
+  bool remove(handle* h);
+  unsigned int remove(handle_listener* hl);
+  void update(handle* h);
+};
+
+CCC_END()
+
+#endif  // !CCC_REACTOR_HH
@@ -0,0 +1,103 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#ifndef CCC_TIMER_WHEEL_HH
+#define CCC_TIMER_WHEEL_HH
+
+#include <cstddef>
+#include <cstdint>
+
+#include "com/centreon/connector/namespace.hh"
+
+CCC_BEGIN()
+
+// Forward declaration.
+class timer_wheel;
+
+/**
+ *  @class timer timer_wheel.hh "com/centreon/connector/timer_wheel.hh"
+ *  @brief Timer node.
+ *
+ *  Timers are embedded in the objects they notify, arming or
+ *  cancelling one never allocates memory. A timer is automatically
+ *  cancelled when destroyed.
+ */
+class timer {
+  friend class timer_wheel;
+
+  uint64_t _deadline;
+  int _level;
+  timer* _next;
+  timer** _pprev;
+  timer_wheel* _wheel;
+
+ public:
+  timer();
+  timer(timer const& t) = delete;
+  virtual ~timer() noexcept;
+  timer& operator=(timer const& t) = delete;
+  void cancel() noexcept;
+  uint64_t get_deadline() const noexcept;
+  bool is_armed() const noexcept;
+  virtual void run() = 0;
+};
+
+/**
+ *  @class timer_wheel timer_wheel.hh "com/centreon/connector/timer_wheel.hh"
+ *  @brief Hierarchical hashed timer wheel.
+ *
+ *  Deadlines are expressed in milliseconds of the monotonic clock,
+ *  which is not affected by system time changes. The first level has
+ *  one slot per millisecond, upper levels cover increasingly larger
+ *  ranges and are cascaded into lower levels as time goes. Adding and
+ *  cancelling a timer are constant time operations.
+ */
+class timer_wheel {
+  friend class timer;
+
+  static int const levels = 5;
+  static int const root_bits = 8;
+  static int const level_bits = 6;
+  static uint64_t const root_size = 1 << root_bits;
+  static uint64_t const level_size = 1 << level_bits;
+
+  uint64_t _next_tick;
+  timer* _root[root_size];
+  size_t _size;
+  size_t _sizes[levels];
+  timer* _slots[levels - 1][level_size];
+
+  uint64_t _cascade(int level);
+  void _link(timer& t);
+  void _unlink(timer& t) noexcept;
+
+ public:
+  timer_wheel(uint64_t origin = now());
+  timer_wheel(timer_wheel const& tw) = delete;
+  virtual ~timer_wheel() noexcept;
+  timer_wheel& operator=(timer_wheel const& tw) = delete;
+  void add(timer& t, uint64_t deadline);
+  unsigned int expire(uint64_t until = now());
+  long next_timeout(uint64_t from = now()) const noexcept;
+  static uint64_t now() noexcept;
+  size_t size() const noexcept;
+};
+
+CCC_END()
+
+#endif  // !CCC_TIMER_WHEEL_HH
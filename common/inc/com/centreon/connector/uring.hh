@@ -0,0 +1,81 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#ifndef CCC_URING_HH
+#define CCC_URING_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "com/centreon/connector/namespace.hh"
+
+// Forward declarations.
+struct io_uring_cqe;
+struct io_uring_sqe;
+
+CCC_BEGIN()
+
+/**
+ *  @class uring uring.hh "com/centreon/connector/uring.hh"
+ *  @brief Minimal io_uring instance.
+ *
+ *  Submission entries are queued in the shared ring and sent to the
+ *  kernel in a single system call along with the wait for completions.
+ *  Construction fails on kernels that do not provide the features we
+ *  rely on.
+ */
+class uring {
+ public:
+  struct completion {
+    uint64_t user_data;
+    int res;
+  };
+
+  uring(unsigned int entries);
+  uring(uring const& u) = delete;
+  ~uring() noexcept;
+  uring& operator=(uring const& u) = delete;
+  void consume(std::vector<completion>& completions);
+  void poll_add(int fd, uint32_t events, uint64_t user_data);
+  void poll_remove(uint64_t user_data);
+  void wait(int timeout);
+
+ private:
+  void _enter(unsigned int min_complete, int timeout);
+  io_uring_sqe* _get_sqe();
+
+  unsigned int* _cq_head;
+  unsigned int* _cq_mask;
+  unsigned int* _cq_tail;
+  io_uring_cqe* _cqes;
+  int _fd;
+  void* _ring;
+  size_t _ring_size;
+  unsigned int* _sq_array;
+  unsigned int _sq_entries;
+  unsigned int* _sq_head;
+  unsigned int* _sq_mask;
+  unsigned int* _sq_tail;
+  io_uring_sqe* _sqes;
+  size_t _sqes_size;
+};
+
+CCC_END()
+
+#endif  // !CCC_URING_HH
@@ -24,7 +24,7 @@
 
 using namespace com::centreon::connector;
 
-log::log() {
+log::log() : _on_stderr(false) {
   auto filesink = std::make_shared<spdlog::sinks::null_sink_mt>();
   _core_log = std::make_shared<spdlog::logger>("core", filesink);
   _core_log->info("log started");
@@ -50,6 +50,7 @@ void log::switch_to_stdout() {
   auto filesink = std::make_shared<spdlog::sinks::stderr_color_sink_mt>();
   spdlog::level::level_enum lvl = _core_log->level();
   _core_log = std::make_shared<spdlog::logger>("core", filesink);
+  _on_stderr = true;
   _core_log->info("log started");
   _core_log->set_level(lvl);
   _core_log->flush_on(lvl);
@@ -59,11 +60,16 @@ void log::switch_to_file(std::string const& filename) {
   auto filesink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(filename);
   spdlog::level::level_enum lvl = _core_log->level();
   _core_log = std::make_shared<spdlog::logger>("core", filesink);
+  _on_stderr = false;
   _core_log->info("log started");
   _core_log->set_level(lvl);
   _core_log->flush_on(lvl);
 }
 
+bool log::is_on_stderr() const noexcept {
+  return _on_stderr;
+}
+
 std::shared_ptr<spdlog::logger> log::core() {
   return log::instance()._core_log;
 }
\ No newline at end of file
@@ -0,0 +1,410 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#include "com/centreon/connector/reactor.hh"
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#include "com/centreon/connector/log.hh"
+#include "com/centreon/exceptions/basic.hh"
+#include "com/centreon/timestamp.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::connector;
+
+// Maximum number of events fetched by a single epoll_wait() call.
+static int const max_events = 128;
+
+#ifdef WITH_IO_URING
+// Size of the io_uring submission queue.
+static unsigned int const uring_entries = 256;
+#endif  // WITH_IO_URING
+
+/**************************************
+ *                                     *
+ *           Public Methods            *
+ *                                     *
+ **************************************/
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] tm Task manager whose tasks are run by multiplex(), can
+ *                be null.
+ *  @param[in] tw Timer wheel whose timers are run by multiplex(), can
+ *                be null.
+ */
+reactor::reactor(task_manager* tm, timer_wheel* tw)
+    : _epoll_fd(-1), _task_manager(tm), _timer_wheel(tw) {
+#ifdef WITH_IO_URING
+  _next_poll_id = 0;
+  try {
+    _uring.reset(new uring(uring_entries));
+    return;
+  } catch (std::exception const& e) {
+    log::core()->info("io_uring is not available, falling back to epoll: {}",
+                      e.what());
+  }
+#endif  // WITH_IO_URING
+  _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (_epoll_fd < 0) {
+    char const* msg(strerror(errno));
+    throw basic_error() << "could not create epoll instance: " << msg;
+  }
+}
+
+/**
+ *  Destructor.
+ */
+reactor::~reactor() noexcept {
+  if (_epoll_fd >= 0)
+    ::close(_epoll_fd);
+}
+
+/**
+ *  Monitor a handle.
+ *
+ *  @param[in] h  Handle.
+ *  @param[in] hl Listener notified of handle events.
+ */
+void reactor::add(handle* h, handle_listener* hl) {
+  if (!h || !hl)
+    throw basic_error() << "attempt to add null handle or listener in reactor";
+  if (_handles.find(h) != _handles.end())
+    throw basic_error() << "handle is already monitored by reactor";
+
+  std::unique_ptr<entry> e(new entry);
+  e->events = 0;
+  e->h = h;
+  e->hl = hl;
+  e->is_dirty = false;
+  e->is_polled = true;
+  e->is_removed = false;
+  e->poll_id = 0;
+
+  // Interest is computed on next iteration, only errors are reported
+  // until then.
+#ifdef WITH_IO_URING
+  if (_uring) {
+    _mark_dirty(e.get());
+    _handles[h] = std::move(e);
+    return;
+  }
+#endif  // WITH_IO_URING
+  epoll_event ev;
+  ev.events = 0;
+  ev.data.ptr = e.get();
+  if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, h->get_native_handle(), &ev)) {
+    // Regular files cannot be polled, they are always ready.
+    if (errno != EPERM) {
+      char const* msg(strerror(errno));
+      throw basic_error() << "could not add handle to reactor: " << msg;
+    }
+    e->is_polled = false;
+    _unpolled.push_back(e.get());
+  }
+  _mark_dirty(e.get());
+  _handles[h] = std::move(e);
+}
+
+/**
+ *  Wait for handle events, notify listeners and run due timers and
+ *  tasks.
+ */
+void reactor::multiplex() {
+  // Entries removed during previous iteration cannot be referenced
+  // anymore once interests are refreshed.
+  _refresh();
+  _graveyard.clear();
+
+#ifdef WITH_IO_URING
+  if (_uring)
+    _uring_multiplex();
+  else
+#endif  // WITH_IO_URING
+    _epoll_multiplex();
+
+  // Run timers and tasks.
+  if (_timer_wheel)
+    _timer_wheel->expire();
+  if (_task_manager)
+    _task_manager->execute(timestamp::now());
+}
+
+/**
+ *  Stop monitoring a handle.
+ *
+ *  @param[in] h Handle.
+ *
+ *  @return true if the handle was monitored.
+ */
+bool reactor::remove(handle* h) {
+  auto it(_handles.find(h));
+  if (it == _handles.end())
+    return false;
+  _release(it);
+  return true;
+}
+
+/**
+ *  Stop monitoring all handles of a listener.
+ *
+ *  @param[in] hl Listener.
+ *
+ *  @return Number of handles removed.
+ */
+unsigned int reactor::remove(handle_listener* hl) {
+  unsigned int count(0);
+  for (auto it(_handles.begin()); it != _handles.end();) {
+    auto current(it++);
+    if (current->second->hl == hl) {
+      _release(current);
+      ++count;
+    }
+  }
+  return count;
+}
+
+/**
+ *  Ask the listener of a handle for its interest on next iteration.
+ *  This must be called when the result of want_read() or want_write()
+ *  changes outside of the handle callbacks.
+ *
+ *  @param[in] h Handle.
+ */
+void reactor::update(handle* h) {
+  auto it(_handles.find(h));
+  if (it != _handles.end())
+    _mark_dirty(it->second.get());
+}
+
+/**************************************
+ *                                     *
+ *           Private Methods           *
+ *                                     *
+ **************************************/
+
+/**
+ *  Notify the listener of a handle.
+ *
+ *  @param[in] e       Handle entry.
+ *  @param[in] revents Events reported for the handle.
+ */
+void reactor::_dispatch(entry* e, uint32_t revents) {
+  if (e->is_removed || !revents)
+    return;
+
+  // Callbacks usually change what the listener waits for.
+  _mark_dirty(e);
+
+  handle& h(*e->h);
+  handle_listener& hl(*e->hl);
+  if ((revents & EPOLLERR) ||
+      ((revents & EPOLLHUP) && !(e->events & EPOLLIN))) {
+    hl.error(h);
+    if (!e->is_removed)
+      remove(&h);
+    return;
+  }
+  if ((revents & (EPOLLIN | EPOLLHUP)) && (e->events & EPOLLIN))
+    hl.read(h);
+  if (!e->is_removed && (revents & EPOLLOUT) && (e->events & EPOLLOUT))
+    hl.write(h);
+}
+
+/**
+ *  Wait for epoll events and notify listeners.
+ */
+void reactor::_epoll_multiplex() {
+  epoll_event events[max_events];
+  int count(epoll_wait(_epoll_fd, events, max_events, _wait_timeout()));
+  if (count < 0) {
+    if (errno != EINTR) {
+      char const* msg(strerror(errno));
+      throw basic_error() << "could not wait for handle events: " << msg;
+    }
+    count = 0;
+  }
+
+  // Dispatch events.
+  for (int i(0); i < count; ++i)
+    _dispatch(static_cast<entry*>(events[i].data.ptr), events[i].events);
+  if (!_unpolled.empty()) {
+    std::vector<entry*> unpolled(_unpolled);
+    for (entry* e : unpolled)
+      _dispatch(e, e->events);
+  }
+}
+
+/**
+ *  Mark the interest of an entry as outdated.
+ *
+ *  @param[in] e Handle entry.
+ */
+void reactor::_mark_dirty(entry* e) {
+  if (!e->is_dirty) {
+    e->is_dirty = true;
+    _dirty.push_back(e);
+  }
+}
+
+/**
+ *  Update the kernel interest of outdated entries.
+ */
+void reactor::_refresh() {
+  for (entry* e : _dirty) {
+    if (e->is_removed)
+      continue;
+    e->is_dirty = false;
+#ifdef WITH_IO_URING
+    if (_uring) {
+      _uring_update(e);
+      continue;
+    }
+#endif  // WITH_IO_URING
+    uint32_t events(0);
+    if (e->hl->want_read(*e->h))
+      events |= EPOLLIN;
+    if (e->hl->want_write(*e->h))
+      events |= EPOLLOUT;
+    if (events != e->events) {
+      e->events = events;
+      if (e->is_polled) {
+        epoll_event ev;
+        ev.events = events;
+        ev.data.ptr = e;
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, e->h->get_native_handle(),
+                      &ev)) {
+          char const* msg(strerror(errno));
+          throw basic_error() << "could not update handle in reactor: "
+                              << msg;
+        }
+      }
+    }
+  }
+  _dirty.clear();
+}
+
+/**
+ *  Remove an entry. Its memory is kept until next iteration because
+ *  pending events might still reference it.
+ *
+ *  @param[in] it Entry iterator.
+ */
+void reactor::_release(umap<handle*, std::unique_ptr<entry>>::iterator it) {
+  entry* e(it->second.get());
+  e->is_removed = true;
+#ifdef WITH_IO_URING
+  if (_uring) {
+    if (e->poll_id) {
+      _uring->poll_remove(e->poll_id);
+      _polls.erase(e->poll_id);
+    }
+  } else
+#endif  // WITH_IO_URING
+  if (e->is_polled)
+    // The descriptor might already be closed, errors are irrelevant.
+    epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, e->h->get_native_handle(), nullptr);
+  else
+    _unpolled.erase(std::find(_unpolled.begin(), _unpolled.end(), e));
+  _graveyard.push_back(std::move(it->second));
+  _handles.erase(it);
+}
+
+/**
+ *  Get the time epoll_wait() can block.
+ *
+ *  @return Timeout in milliseconds, -1 for no timeout.
+ */
+int reactor::_wait_timeout() const {
+  for (entry* e : _unpolled)
+    if (e->events)
+      return 0;
+
+  long long timeout(-1);
+  if (_timer_wheel)
+    timeout = _timer_wheel->next_timeout();
+  if (_task_manager) {
+    timestamp next(_task_manager->next_execution_time());
+    if (next != timestamp::max_time()) {
+      long long usecs(next.to_useconds() - timestamp::now().to_useconds());
+      long long msecs(usecs <= 0 ? 0 : (usecs + 999) / 1000);
+      if (timeout < 0 || msecs < timeout)
+        timeout = msecs;
+    }
+  }
+  return static_cast<int>(std::min<long long>(timeout, INT_MAX));
+}
+
+#ifdef WITH_IO_URING
+/**
+ *  Submit pending poll requests, wait for their completion and notify
+ *  listeners.
+ */
+void reactor::_uring_multiplex() {
+  _uring->wait(_wait_timeout());
+  _completions.clear();
+  _uring->consume(_completions);
+  for (uring::completion const& c : _completions) {
+    // Completions of cancelled requests are ignored.
+    auto it(_polls.find(c.user_data));
+    if (it == _polls.end())
+      continue;
+    entry* e(it->second);
+    _polls.erase(it);
+
+    // Poll requests are one-shot, they are submitted again on next
+    // iteration.
+    e->poll_id = 0;
+    _dispatch(e, c.res < 0 ? EPOLLERR : static_cast<uint32_t>(c.res));
+  }
+}
+
+/**
+ *  Submit the poll request matching the current interest of an entry.
+ *
+ *  @param[in] e Handle entry.
+ */
+void reactor::_uring_update(entry* e) {
+  uint32_t events(0);
+  if (e->hl->want_read(*e->h))
+    events |= EPOLLIN;
+  if (e->hl->want_write(*e->h))
+    events |= EPOLLOUT;
+  if (e->poll_id && events == e->events)
+    return;
+
+  e->events = events;
+  if (e->poll_id) {
+    _uring->poll_remove(e->poll_id);
+    _polls.erase(e->poll_id);
+    e->poll_id = 0;
+  }
+  if (events) {
+    e->poll_id = ++_next_poll_id;
+    _uring->poll_add(e->h->get_native_handle(), events, e->poll_id);
+    _polls[e->poll_id] = e;
+  }
+}
+#endif  // WITH_IO_URING
@@ -0,0 +1,315 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#include "com/centreon/connector/timer_wheel.hh"
+
+#include <climits>
+#include <ctime>
+
+using namespace com::centreon::connector;
+
+/**************************************
+ *                                     *
+ *           Public Methods            *
+ *                                     *
+ **************************************/
+
+/**
+ *  Constructor.
+ */
+timer::timer()
+    : _deadline(0),
+      _level(-1),
+      _next(nullptr),
+      _pprev(nullptr),
+      _wheel(nullptr) {}
+
+/**
+ *  Destructor.
+ */
+timer::~timer() noexcept {
+  cancel();
+}
+
+/**
+ *  Cancel the timer if it is armed.
+ */
+void timer::cancel() noexcept {
+  if (_wheel)
+    _wheel->_unlink(*this);
+}
+
+/**
+ *  Get the timer deadline.
+ *
+ *  @return Deadline in milliseconds of the monotonic clock.
+ */
+uint64_t timer::get_deadline() const noexcept {
+  return _deadline;
+}
+
+/**
+ *  Check if the timer is armed.
+ *
+ *  @return true if the timer will run.
+ */
+bool timer::is_armed() const noexcept {
+  return _wheel;
+}
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] origin Current time in milliseconds of the monotonic
+ *                    clock.
+ */
+timer_wheel::timer_wheel(uint64_t origin)
+    : _next_tick(origin), _root{}, _size(0), _sizes{}, _slots{} {}
+
+/**
+ *  Destructor. Remaining timers are disarmed.
+ */
+timer_wheel::~timer_wheel() noexcept {
+  auto disarm([](timer* t) {
+    while (t) {
+      timer* next(t->_next);
+      t->_level = -1;
+      t->_next = nullptr;
+      t->_pprev = nullptr;
+      t->_wheel = nullptr;
+      t = next;
+    }
+  });
+  for (timer* t : _root)
+    disarm(t);
+  for (auto& level : _slots)
+    for (timer* t : level)
+      disarm(t);
+}
+
+/**
+ *  Arm a timer. If it was already armed, it is rescheduled.
+ *
+ *  @param[in] t        Timer.
+ *  @param[in] deadline Deadline in milliseconds of the monotonic clock.
+ */
+void timer_wheel::add(timer& t, uint64_t deadline) {
+  t.cancel();
+  t._deadline = deadline;
+  _link(t);
+}
+
+/**
+ *  Run timers whose deadline is reached.
+ *
+ *  @param[in] until Current time in milliseconds of the monotonic
+ *                   clock.
+ *
+ *  @return Number of timers run.
+ */
+unsigned int timer_wheel::expire(uint64_t until) {
+  static uint64_t const mask(root_size - 1);
+  unsigned int count(0);
+  while (_next_tick <= until) {
+    // Skip ticks that would do nothing.
+    if (!_size) {
+      _next_tick = until + 1;
+      break;
+    }
+    if ((_next_tick & mask) && !_sizes[0]) {
+      uint64_t boundary((_next_tick | mask) + 1);
+      if (boundary > until) {
+        _next_tick = until + 1;
+        break;
+      }
+      _next_tick = boundary;
+    }
+
+    // Move timers of upper levels closer.
+    uint64_t idx(_next_tick & mask);
+    if (!idx)
+      for (int level(1); level < levels && !_cascade(level); ++level)
+        ;
+    ++_next_tick;
+
+    // Detach expired timers. They remain cancellable while others run.
+    timer* pending(_root[idx]);
+    _root[idx] = nullptr;
+    if (pending)
+      pending->_pprev = &pending;
+    while (pending) {
+      timer* t(pending);
+      _unlink(*t);
+      t->run();
+      ++count;
+    }
+  }
+  return count;
+}
+
+/**
+ *  Get the time before timers need to be processed again.
+ *
+ *  @param[in] from Current time in milliseconds of the monotonic
+ *                  clock.
+ *
+ *  @return Time in milliseconds, -1 if no timer is armed.
+ */
+long timer_wheel::next_timeout(uint64_t from) const noexcept {
+  static uint64_t const mask(root_size - 1);
+  if (!_size)
+    return -1;
+
+  // Timers of the first level expire at their slot time.
+  uint64_t next(UINT64_MAX);
+  if (_sizes[0])
+    for (uint64_t i(0); i < root_size; ++i)
+      if (_root[(_next_tick + i) & mask]) {
+        next = _next_tick + i;
+        break;
+      }
+
+  // Other timers need to be cascaded first, which happens on first
+  // level boundaries for the second level and on second level
+  // boundaries for upper ones.
+  if (_size > _sizes[0]) {
+    uint64_t boundary((_next_tick + mask) & ~mask);
+    uint64_t limit(UINT64_MAX);
+    if (_size > _sizes[0] + _sizes[1])
+      limit = boundary + (((level_size - (boundary >> root_bits)) &
+                           (level_size - 1)) << root_bits);
+    for (uint64_t i(0); _sizes[1] && i < level_size; ++i) {
+      uint64_t b(boundary + (i << root_bits));
+      if (b >= limit)
+        break;
+      if (_slots[0][(b >> root_bits) & (level_size - 1)]) {
+        limit = b;
+        break;
+      }
+    }
+    if (limit < next)
+      next = limit;
+  }
+
+  if (next <= from)
+    return 0;
+  return next - from > LONG_MAX ? LONG_MAX : next - from;
+}
+
+/**
+ *  Get current time of the monotonic clock.
+ *
+ *  @return Time in milliseconds.
+ */
+uint64_t timer_wheel::now() noexcept {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ *  Get the number of armed timers.
+ *
+ *  @return Number of timers.
+ */
+size_t timer_wheel::size() const noexcept {
+  return _size;
+}
+
+/**************************************
+ *                                     *
+ *           Private Methods           *
+ *                                     *
+ **************************************/
+
+/**
+ *  Move timers of the current slot of a level to lower levels.
+ *
+ *  @param[in] level Level, first level excluded.
+ *
+ *  @return Index of the cascaded slot.
+ */
+uint64_t timer_wheel::_cascade(int level) {
+  uint64_t idx((_next_tick >> (root_bits + (level - 1) * level_bits)) &
+               (level_size - 1));
+  timer* t(_slots[level - 1][idx]);
+  _slots[level - 1][idx] = nullptr;
+  while (t) {
+    timer* next(t->_next);
+    --_sizes[level];
+    --_size;
+    _link(*t);
+    t = next;
+  }
+  return idx;
+}
+
+/**
+ *  Insert a timer in the slot matching its deadline.
+ *
+ *  @param[in] t Timer.
+ */
+void timer_wheel::_link(timer& t) {
+  timer** head;
+  int level(0);
+  if (t._deadline < _next_tick)
+    head = &_root[_next_tick & (root_size - 1)];
+  else if (t._deadline - _next_tick < root_size)
+    head = &_root[t._deadline & (root_size - 1)];
+  else {
+    uint64_t delta(t._deadline - _next_tick);
+    level = 1;
+    while (level < levels - 1 &&
+           delta >= (root_size << (level * level_bits)))
+      ++level;
+
+    // Timers beyond the wheel range are cascaded again later.
+    uint64_t range(root_size << ((levels - 1) * level_bits));
+    uint64_t deadline(delta < range ? t._deadline : _next_tick + range - 1);
+    head = &_slots[level - 1][(deadline >> (root_bits +
+                                            (level - 1) * level_bits)) &
+                              (level_size - 1)];
+  }
+
+  t._next = *head;
+  if (t._next)
+    t._next->_pprev = &t._next;
+  *head = &t;
+  t._pprev = head;
+  t._level = level;
+  t._wheel = this;
+  ++_sizes[level];
+  ++_size;
+}
+
+/**
+ *  Remove a timer from its slot.
+ *
+ *  @param[in] t Armed timer.
+ */
+void timer_wheel::_unlink(timer& t) noexcept {
+  *t._pprev = t._next;
+  if (t._next)
+    t._next->_pprev = t._pprev;
+  --_sizes[t._level];
+  --_size;
+  t._level = -1;
+  t._next = nullptr;
+  t._pprev = nullptr;
+  t._wheel = nullptr;
+}
@@ -0,0 +1,211 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#include "com/centreon/connector/uring.hh"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+
+#include "com/centreon/exceptions/basic.hh"
+
+using namespace com::centreon::connector;
+
+/**************************************
+ *                                     *
+ *           Public Methods            *
+ *                                     *
+ **************************************/
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] entries Size of the submission queue.
+ */
+uring::uring(unsigned int entries)
+    : _ring(MAP_FAILED), _ring_size(0), _sqes(nullptr), _sqes_size(0) {
+  io_uring_params p;
+  memset(&p, 0, sizeof(p));
+  _fd = syscall(__NR_io_uring_setup, entries, &p);
+  if (_fd < 0) {
+    char const* msg(strerror(errno));
+    throw basic_error() << "could not create io_uring instance: " << msg;
+  }
+
+  // Waiting with a timeout needs Linux 5.11.
+  if (!(p.features & IORING_FEAT_SINGLE_MMAP) ||
+      !(p.features & IORING_FEAT_EXT_ARG)) {
+    ::close(_fd);
+    throw basic_error() << "io_uring instance misses required features";
+  }
+
+  // Map rings.
+  _ring_size = std::max(p.sq_off.array + p.sq_entries * sizeof(unsigned int),
+                        p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe));
+  _ring = mmap(nullptr, _ring_size, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+  _sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+  void* sqes(mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES));
+  if (_ring == MAP_FAILED || sqes == MAP_FAILED) {
+    char const* msg(strerror(errno));
+    if (_ring != MAP_FAILED)
+      munmap(_ring, _ring_size);
+    if (sqes != MAP_FAILED)
+      munmap(sqes, _sqes_size);
+    ::close(_fd);
+    throw basic_error() << "could not map io_uring rings: " << msg;
+  }
+  _sqes = static_cast<io_uring_sqe*>(sqes);
+
+  char* ring(static_cast<char*>(_ring));
+  _sq_head = reinterpret_cast<unsigned int*>(ring + p.sq_off.head);
+  _sq_tail = reinterpret_cast<unsigned int*>(ring + p.sq_off.tail);
+  _sq_mask = reinterpret_cast<unsigned int*>(ring + p.sq_off.ring_mask);
+  _sq_array = reinterpret_cast<unsigned int*>(ring + p.sq_off.array);
+  _sq_entries = p.sq_entries;
+  _cq_head = reinterpret_cast<unsigned int*>(ring + p.cq_off.head);
+  _cq_tail = reinterpret_cast<unsigned int*>(ring + p.cq_off.tail);
+  _cq_mask = reinterpret_cast<unsigned int*>(ring + p.cq_off.ring_mask);
+  _cqes = reinterpret_cast<io_uring_cqe*>(ring + p.cq_off.cqes);
+}
+
+/**
+ *  Destructor.
+ */
+uring::~uring() noexcept {
+  munmap(_sqes, _sqes_size);
+  munmap(_ring, _ring_size);
+  ::close(_fd);
+}
+
+/**
+ *  Fetch available completions.
+ *
+ *  @param[out] completions Completions are appended to this vector.
+ */
+void uring::consume(std::vector<completion>& completions) {
+  unsigned int head(*_cq_head);
+  unsigned int tail(__atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE));
+  while (head != tail) {
+    io_uring_cqe const& cqe(_cqes[head & *_cq_mask]);
+    completions.push_back(completion{cqe.user_data, cqe.res});
+    ++head;
+  }
+  __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+}
+
+/**
+ *  Queue a one-shot poll request.
+ *
+ *  @param[in] fd        File descriptor.
+ *  @param[in] events    poll() events.
+ *  @param[in] user_data Request identifier, must not be 0.
+ */
+void uring::poll_add(int fd, uint32_t events, uint64_t user_data) {
+  io_uring_sqe* sqe(_get_sqe());
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+  sqe->poll32_events = events;
+  sqe->user_data = user_data;
+  __atomic_store_n(_sq_tail, *_sq_tail + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ *  Queue the cancellation of a poll request. The cancelled request
+ *  completes with -ECANCELED, the cancellation itself with a null
+ *  identifier.
+ *
+ *  @param[in] user_data Identifier of the poll request.
+ */
+void uring::poll_remove(uint64_t user_data) {
+  io_uring_sqe* sqe(_get_sqe());
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = user_data;
+  sqe->user_data = 0;
+  __atomic_store_n(_sq_tail, *_sq_tail + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ *  Submit queued requests and wait for at least one completion.
+ *
+ *  @param[in] timeout Maximum wait time in milliseconds, -1 for no
+ *                     limit.
+ */
+void uring::wait(int timeout) {
+  bool ready(*_cq_head != __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE));
+  _enter(ready ? 0 : 1, ready ? 0 : timeout);
+}
+
+/**************************************
+ *                                     *
+ *           Private Methods           *
+ *                                     *
+ **************************************/
+
+/**
+ *  Submit queued requests and wait for completions.
+ *
+ *  @param[in] min_complete Number of completions to wait for.
+ *  @param[in] timeout      Maximum wait time in milliseconds, -1 for
+ *                          no limit.
+ */
+void uring::_enter(unsigned int min_complete, int timeout) {
+  __kernel_timespec ts;
+  ts.tv_sec = timeout / 1000;
+  ts.tv_nsec = (timeout % 1000) * 1000000ll;
+  io_uring_getevents_arg arg;
+  memset(&arg, 0, sizeof(arg));
+  arg.sigmask_sz = _NSIG / 8;
+  if (timeout >= 0)
+    arg.ts = reinterpret_cast<uint64_t>(&ts);
+  unsigned int flags(IORING_ENTER_EXT_ARG);
+  if (min_complete)
+    flags |= IORING_ENTER_GETEVENTS;
+
+  unsigned int to_submit(*_sq_tail -
+                         __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE));
+  int ret(syscall(__NR_io_uring_enter, _fd, to_submit, min_complete, flags,
+                  &arg, sizeof(arg)));
+  if (ret < 0 && errno != ETIME && errno != EINTR) {
+    char const* msg(strerror(errno));
+    throw basic_error() << "could not submit io_uring requests: " << msg;
+  }
+}
+
+/**
+ *  Get a free submission entry, flushing the queue if it is full.
+ *
+ *  @return Cleared submission entry.
+ */
+io_uring_sqe* uring::_get_sqe() {
+  if (*_sq_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) >= _sq_entries)
+    _enter(0, 0);
+  unsigned int idx(*_sq_tail & *_sq_mask);
+  _sq_array[idx] = idx;
+  io_uring_sqe* sqe(&_sqes[idx]);
+  memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
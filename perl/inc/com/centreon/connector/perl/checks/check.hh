@@ -21,6 +21,7 @@
 
 #include <sys/types.h>
 #include <string>
+#include "com/centreon/connector/perl/checks/timeout.hh"
 #include "com/centreon/connector/perl/namespace.hh"
 #include "com/centreon/connector/perl/pipe_handle.hh"
 #include "com/centreon/handle_listener.hh"
@@ -41,34 +42,50 @@ class result;
  */
 class check : public handle_listener {
  public:
-  check();
+  check(size_t max_output_size = 0, bool memfd = false);
   ~check() noexcept;
   check(check const& c) = delete;
   check& operator=(check const& c) = delete;
+  void complete(int exit_code,
+                std::string const& out,
+                std::string const& err,
+                bool out_truncated,
+                bool err_truncated);
   void error(handle& h) override;
   pid_t execute(uint64_t cmd_id,
                 std::string const& cmd,
                 const timestamp& tmt);
+  void fail();
   void listen(listener* listnr);
   void on_timeout(bool final = true);
+  void prepare(uint64_t cmd_id, const timestamp& tmt);
   void read(handle& h) override;
+  void start(pid_t child, int out_fd, int err_fd);
+  void start_in_process(pid_t worker);
   void terminated(int exit_code);
   void unlisten(listener* listnr);
   bool want_read(handle& h) override;
   void write(handle& h) override;
 
  private:
-
+  void _append(std::string& data, char const* buffer, size_t size);
+  void _read_file(pipe_handle& h, std::string& data);
   void _send_result_and_unregister(result const& r);
 
   pid_t _child;
   uint64_t _cmd_id;
   pipe_handle _err;
+  timeout _final_timeout;
+  bool _in_process;
   listener* _listnr;
+  size_t _max_output_size;
+  bool _memfd;
   pipe_handle _out;
   std::string _stderr;
+  bool _stderr_truncated;
   std::string _stdout;
-  unsigned long _timeout;
+  bool _stdout_truncated;
+  timeout _timeout;
 };
 }  // namespace checks
 
@@ -35,8 +35,10 @@ class result {
  public:
   result();
   result(result const& r) = delete;
+  result(result&& r) noexcept;
   ~result() = default;
   result& operator=(result const& r) = delete;
+  result& operator=(result&& r) noexcept;
   uint64_t get_command_id() const noexcept;
   std::string const& get_error() const noexcept;
   bool get_executed() const noexcept;
@@ -44,9 +46,11 @@ class result {
   std::string const& get_output() const noexcept;
   void set_command_id(uint64_t cmd_id) noexcept;
   void set_error(std::string const& error);
+  void set_error(std::string&& error) noexcept;
   void set_executed(bool executed) noexcept;
   void set_exit_code(int code) noexcept;
   void set_output(std::string const& output);
+  void set_output(std::string&& output) noexcept;
 
  private:
   uint64_t _cmd_id;
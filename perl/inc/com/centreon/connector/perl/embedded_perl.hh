@@ -23,7 +23,10 @@
 #include <perl.h>
 #include <sys/types.h>
 #include <string>
+#include <vector>
 #include "com/centreon/connector/perl/namespace.hh"
+#include "com/centreon/connector/perl/pipe_handle.hh"
+#include "com/centreon/handle_listener.hh"
 #include "com/centreon/unordered_hash.hh"
 
 // Global Perl interpreter.
@@ -37,26 +40,74 @@ CCCP_BEGIN()
  *  @brief Embedded Perl interpreter.
  *
  *  Embedded Perl interpreter wrapped in a singleton.
+ *
+ *  Directories of compiled scripts are watched with inotify, changed
+ *  scripts are compiled again on their next run. The watcher must be
+ *  read by the event loop of the process running checks.
  */
-class embedded_perl {
+class embedded_perl : public handle_listener {
  public:
-  ~embedded_perl();
+  ~embedded_perl() override;
+  void error(handle& h) override;
+  void expire_changed();
+  pipe_handle& get_watcher() noexcept;
   static embedded_perl& instance();
+  bool is_in_process(std::string const& cmd);
   static void load(int* argc,
                    char*** argv,
                    char*** env,
                    char const* code = NULL);
-  pid_t run(std::string const& cmd, int fds[3]);
+  void read(handle& h) override;
+  void renew_watcher();
+  pid_t run(std::string const& cmd, int fds[2], bool memfd = false);
+  int run_in_process(std::string const& cmd,
+                     unsigned int timeout_ms,
+                     std::string& out,
+                     std::string& err);
+  static void set_autoflush(bool enable);
+  static void set_warm_up(std::string const& manifest,
+                          std::string const& directory);
   static void unload();
+  void warm_up();
+  bool want_read(handle& h) override;
 
  private:
+  struct failure {
+    dev_t dev;
+    std::string error;
+    bool exists;
+    ino_t ino;
+    timespec mtime;
+    off_t size;
+  };
+
   embedded_perl(int* argc, char*** argv, char*** env, char const* code = NULL);
   embedded_perl(embedded_perl const& ep);
   embedded_perl& operator=(embedded_perl const& ep);
+  SV* _compile(std::string const& file);
+  void _expire(std::string const& file);
+  static void _identify(std::string const& file, failure& id);
+  static bool _is_perl_script(std::string const& file);
+  void _record(std::string const& file);
+  static int _open_output(int fds[2], bool memfd, char const* name);
+  void _open_watcher();
+  static void _split(std::string const& cmd,
+                     std::string& file,
+                     std::string& args);
+  void _watch(std::string const& file);
+  void _write_manifest();
 
+  static bool _autoflush;
+  umap<std::string, failure> _failed;
+  static std::string _manifest;
+  int _null_fd;
   umap<std::string, SV*> _parsed;
   static char const* const _script;
   pid_t _self;
+  static std::string _warm_up_dir;
+  bool _warming_up;
+  pipe_handle _watcher;
+  umap<int, std::vector<std::string> > _watches;
 };
 
 CCCP_END()
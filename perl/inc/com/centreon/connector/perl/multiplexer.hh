@@ -20,7 +20,8 @@
 #define CCCP_MULTIPLEXER_HH
 
 #include "com/centreon/connector/perl/namespace.hh"
-#include "com/centreon/handle_manager.hh"
+#include "com/centreon/connector/reactor.hh"
+#include "com/centreon/connector/timer_wheel.hh"
 #include "com/centreon/task_manager.hh"
 
 CCCP_BEGIN()
@@ -34,7 +35,8 @@ CCCP_BEGIN()
  *  descriptor monitoring and task execution.
  */
 class multiplexer : public com::centreon::task_manager,
-                    public com::centreon::handle_manager {
+                    public com::centreon::connector::timer_wheel,
+                    public com::centreon::connector::reactor {
  public:
   static void load();
   static void unload();
@@ -38,6 +38,8 @@ class options : public com::centreon::misc::get_options {
   ~options() noexcept override;
   options(options const& opts) = delete;
   options& operator=(options const& opts) = delete;
+  unsigned int get_unsigned(std::string const& long_name,
+                            unsigned int default_value = 0) const;
   std::string help() const override;
   void parse(int argc, char* argv[]);
   std::string usage() const override;
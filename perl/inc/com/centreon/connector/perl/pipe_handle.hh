@@ -40,7 +40,6 @@ class pipe_handle : public handle {
   pipe_handle(pipe_handle const& ph) = delete;
   pipe_handle& operator=(pipe_handle const& ph) = delete;
   void close() noexcept override;
-  static void close_all_handles();
   native_handle get_native_handle() noexcept override;
   unsigned long read(void* data, unsigned long size) override;
   void set_fd(int fd);
@@ -22,18 +22,22 @@
 #include <sys/types.h>
 
 #include <map>
+#include <memory>
 
 #include "com/centreon/connector/perl/checks/listener.hh"
 #include "com/centreon/connector/perl/namespace.hh"
 #include "com/centreon/connector/perl/orders/listener.hh"
 #include "com/centreon/connector/perl/orders/parser.hh"
+#include "com/centreon/connector/perl/reaper.hh"
 #include "com/centreon/connector/perl/reporter.hh"
+#include "com/centreon/connector/perl/worker_pool.hh"
 #include "com/centreon/io/file_stream.hh"
 #include "com/centreon/timestamp.hh"
 
 CCCP_BEGIN()
 
 // Forward declarations.
+class options;
 namespace checks {
 class check;
 class result;
@@ -48,13 +52,19 @@ class result;
 class policy : public orders::listener, public checks::listener {
   std::map<pid_t, checks::check*> _checks;
   bool _error;
+  size_t _max_output_size;
+  bool _memfd;
   orders::parser _parser;
+  reaper _reaper;
   reporter _reporter;
   io::file_stream _sin;
   io::file_stream _sout;
+  std::unique_ptr<worker_pool> _workers;
+
+  void _on_exit(pid_t pid, int status);
 
  public:
-  policy();
+  policy(options const& opts);
   ~policy() noexcept override;
   policy(policy const& p) = delete;
   policy& operator=(policy const& p) = delete;
@@ -0,0 +1,65 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#ifndef CCCP_REAPER_HH
+#define CCCP_REAPER_HH
+
+#include <sys/types.h>
+#include <functional>
+#include <memory>
+#include "com/centreon/connector/perl/namespace.hh"
+#include "com/centreon/connector/perl/pipe_handle.hh"
+#include "com/centreon/handle_listener.hh"
+#include "com/centreon/unordered_hash.hh"
+
+CCCP_BEGIN()
+
+/**
+ *  @class reaper reaper.hh "com/centreon/connector/perl/reaper.hh"
+ *  @brief Report children termination through the multiplexer.
+ *
+ *  Each watched process is tracked with a pidfd registered in the
+ *  multiplexer, so its exit wakes the event loop and is reported at
+ *  once. If the kernel has no pidfd support, SIGCHLD is read from a
+ *  signalfd instead and watched processes are all polled when it
+ *  fires.
+ */
+class reaper : public handle_listener {
+ public:
+  reaper(std::function<void(pid_t, int)> callback);
+  ~reaper() noexcept override;
+  reaper(reaper const& r) = delete;
+  reaper& operator=(reaper const& r) = delete;
+  void error(handle& h) override;
+  void read(handle& h) override;
+  void unwatch(pid_t pid);
+  void watch(pid_t pid);
+  bool want_read(handle& h) override;
+
+ private:
+  bool _reap(pid_t pid);
+
+  std::function<void(pid_t, int)> _callback;
+  umap<handle*, pid_t> _fds;
+  umap<pid_t, std::unique_ptr<pipe_handle> > _pids;
+  std::unique_ptr<pipe_handle> _sigchld;
+};
+
+CCCP_END()
+
+#endif  // !CCCP_REAPER_HH
@@ -0,0 +1,120 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#ifndef CCCP_WORKER_POOL_HH
+#define CCCP_WORKER_POOL_HH
+
+#include <sys/types.h>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include "com/centreon/connector/perl/namespace.hh"
+#include "com/centreon/connector/perl/pipe_handle.hh"
+#include "com/centreon/handle_listener.hh"
+#include "com/centreon/timestamp.hh"
+#include "com/centreon/unordered_hash.hh"
+
+CCCP_BEGIN()
+
+// Forward declarations.
+namespace checks {
+class check;
+}
+class reaper;
+
+/**
+ *  @class worker_pool worker_pool.hh
+ * "com/centreon/connector/perl/worker_pool.hh"
+ *  @brief Pool of long-lived processes starting checks.
+ *
+ *  Worker processes are forked from the connector once Perl is loaded,
+ *  so they share its compiled plugins. They receive checks over a
+ *  socketpair, fork them, and send back their output descriptors and
+ *  exit status. The connector itself does not fork anymore, except to
+ *  replace a worker that reached its maximum number of checks.
+ *
+ *  In zygote mode the connector never loads Perl. Workers are forked
+ *  from the lightweight connector and load the interpreter themselves,
+ *  so the cost of forking does not depend on the interpreter size.
+ *
+ *  Scripts marked with '# nagios: +epn' can run within workers,
+ *  without forking at all. A worker running such a script is blocked
+ *  until it is over, new checks go to other workers meanwhile.
+ *
+ *  Orders are queued per worker while its socket is full, so that a
+ *  busy worker never blocks the connector.
+ */
+class worker_pool : public handle_listener {
+ public:
+  worker_pool(reaper& processes,
+              unsigned int size,
+              unsigned int max_checks = 0,
+              bool zygote = false,
+              std::string const& code = std::string(),
+              bool in_process = false,
+              bool memfd = false);
+  ~worker_pool() noexcept override;
+  worker_pool(worker_pool const& wp) = delete;
+  worker_pool& operator=(worker_pool const& wp) = delete;
+  void error(handle& h) override;
+  void execute(uint64_t cmd_id,
+               std::string const& cmd,
+               const timestamp& tmt,
+               std::unique_ptr<checks::check>&& chk);
+  size_t get_checks_count() const noexcept;
+  void read(handle& h) override;
+  bool want_read(handle& h) override;
+  bool want_write(handle& h) override;
+  void write(handle& h) override;
+
+ private:
+  struct worker {
+    bool blocked;
+    unsigned int checks_count;
+    std::list<std::string> orders;
+    pid_t pid;
+    bool retiring;
+    unsigned int running;
+    pipe_handle sock;
+  };
+
+  void _close(worker* w);
+  worker* _find(handle& h) const noexcept;
+  void _retire(worker* w);
+  void _run_in_process(int sock,
+                       uint64_t cmd_id,
+                       std::string const& cmd,
+                       uint64_t deadline);
+  void _spawn();
+  [[noreturn]] void _work(int sock);
+
+  umap<uint64_t, std::pair<checks::check*, worker*> > _checks;
+  std::string _code;
+  bool _in_process;
+  unsigned int _max_checks;
+  bool _memfd;
+  reaper& _reaper;
+  unsigned int _size;
+  std::list<std::unique_ptr<worker> > _workers;
+  bool _zygote;
+};
+
+CCCP_END()
+
+#endif  // !CCCP_WORKER_POOL_HH
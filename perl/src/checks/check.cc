@@ -18,14 +18,16 @@
 
 #include "com/centreon/connector/perl/checks/check.hh"
 
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <csignal>
 #include <cstdlib>
-#include <memory>
+#include <utility>
 
 #include "com/centreon/connector/log.hh"
 #include "com/centreon/connector/perl/checks/listener.hh"
 #include "com/centreon/connector/perl/checks/result.hh"
-#include "com/centreon/connector/perl/checks/timeout.hh"
 #include "com/centreon/connector/perl/embedded_perl.hh"
 #include "com/centreon/connector/perl/multiplexer.hh"
 
@@ -33,6 +35,12 @@ using namespace com::centreon;
 using namespace com::centreon::connector;
 using namespace com::centreon::connector::perl::checks;
 
+// Appended to output truncated because of the size limit.
+static char const truncation_marker[] = "\n(output truncated)";
+
+// Delay between SIGTERM and SIGKILL of a timeouting process.
+static uint64_t const kill_delay_ms = 1000;
+
 /**************************************
  *                                     *
  *           Public Methods            *
@@ -40,9 +48,24 @@ using namespace com::centreon::connector::perl::checks;
  **************************************/
 
 /**
- *  Default constructor.
+ *  Constructor.
+ *
+ *  @param[in] max_output_size Maximum size of each output stream, 0
+ *                             for no limit.
+ *  @param[in] memfd           Outputs are memory files read once the
+ *                             process exited.
  */
-check::check() : _child((pid_t)-1), _cmd_id(0), _listnr(nullptr), _timeout(0) {}
+check::check(size_t max_output_size, bool memfd)
+    : _child((pid_t)-1),
+      _cmd_id(0),
+      _final_timeout(this, true),
+      _in_process(false),
+      _listnr(nullptr),
+      _max_output_size(max_output_size),
+      _memfd(memfd),
+      _stderr_truncated(false),
+      _stdout_truncated(false),
+      _timeout(this, false) {}
 
 /**
  *  Destructor.
@@ -82,28 +105,48 @@ pid_t check::execute(uint64_t cmd_id,
                      std::string const& cmd,
                      const timestamp& tmt) {
   // Run process.
-  int fds[3];
-  _child = embedded_perl::instance().run(cmd, fds);
-  ::close(fds[0]);
-  _out.set_fd(fds[1]);
-  _err.set_fd(fds[2]);
+  int fds[2];
+  pid_t child(embedded_perl::instance().run(cmd, fds, _memfd));
 
-  // Store command ID.
-  log::core()->debug("check {0} has ID {1}", static_cast<void*>(this),
-                        cmd_id);
-  _cmd_id = cmd_id;
-
-  // Register with multiplexer.
-  multiplexer::instance().handle_manager::add(&_err, this);
-  multiplexer::instance().handle_manager::add(&_out, this);
+  prepare(cmd_id, tmt);
+  start(child, fds[0], fds[1]);
+  return _child;
+}
 
-  // Register timeout.
-  std::unique_ptr<timeout> t(new timeout(this, false));
-  _timeout = multiplexer::instance().com::centreon::task_manager::add(
-      t.get(), tmt, false, true);
-  t.release();
+/**
+ *  A check run in-process by a worker is over.
+ *
+ *  @param[in] exit_code     Exit code.
+ *  @param[in] out           Standard output.
+ *  @param[in] err           Error output.
+ *  @param[in] out_truncated The worker cut the standard output.
+ *  @param[in] err_truncated The worker cut the error output.
+ */
+void check::complete(int exit_code,
+                     std::string const& out,
+                     std::string const& err,
+                     bool out_truncated,
+                     bool err_truncated) {
+  _child = (pid_t)-1;
+  _append(_stdout, out.data(), out.size());
+  _append(_stderr, err.data(), err.size());
+  if (out_truncated)
+    _stdout_truncated = true;
+  if (err_truncated)
+    _stderr_truncated = true;
+  terminated(exit_code);
+}
 
-  return _child;
+/**
+ *  The check could not be started, send a result telling so.
+ */
+void check::fail() {
+  // The worker running the check in-process is gone.
+  if (_in_process)
+    _child = (pid_t)-1;
+  result r;
+  r.set_command_id(_cmd_id);
+  _send_result_and_unregister(r);
 }
 
 /**
@@ -126,82 +169,163 @@ void check::on_timeout(bool final) {
   // Log message.
   log::core()->error("check {0} (pid={1}) reached timeout", _cmd_id, _child);
 
-  // Reset timeout task ID.
-  _timeout = 0;
-
-  if (_child <= 0)
+  if (_child <= 0) {
+    // The worker did not start the check yet. Report it now, its
+    // process gets killed as soon as it is announced.
+    if (_cmd_id && !final) {
+      result r;
+      r.set_command_id(_cmd_id);
+      r.set_executed(true);
+      r.set_exit_code(-1);
+      _send_result_and_unregister(r);
+    }
     return;
+  }
 
   if (final) {
-    // Send SIGKILL (not catchable, not ignorable).
+    // Send SIGKILL (not catchable, not ignorable). A check running
+    // in-process did not obey the watchdog of its worker, the worker
+    // goes with it.
     kill(_child, SIGKILL);
     _child = (pid_t)-1;
   } else {
-    // Try graceful shutdown.
-    kill(_child, SIGTERM);
+    // Try graceful shutdown. The watchdog of the worker interrupts
+    // checks running in-process.
+    if (!_in_process)
+      kill(_child, SIGTERM);
 
     // Schedule a final timeout.
-    std::unique_ptr<timeout> t(new timeout(this, true));
-    _timeout = multiplexer::instance().com::centreon::task_manager::add(
-        t.get(), time(nullptr) + 1, false, true);
-    t.release();
+    multiplexer::instance().timer_wheel::add(
+        _final_timeout, timer_wheel::now() + kill_delay_ms);
   }
 }
 
+/**
+ *  Prepare a check whose process is started by someone else (a worker
+ *  process). Its timeout runs from now on.
+ *
+ *  @param[in] cmd_id Command ID.
+ *  @param[in] tmt    Timeout.
+ */
+void check::prepare(uint64_t cmd_id, const timestamp& tmt) {
+  // Store command ID.
+  log::core()->debug("check {0} has ID {1}", static_cast<void*>(this),
+                        cmd_id);
+  _cmd_id = cmd_id;
+
+  // Register timeout. The deadline is converted once to the monotonic
+  // clock so that system time changes do not affect it.
+  long long remaining(tmt.to_mseconds() - timestamp::now().to_mseconds());
+  multiplexer::instance().timer_wheel::add(
+      _timeout, timer_wheel::now() + (remaining > 0 ? remaining : 0));
+}
+
 /**
  *  Read data from handle.
  *
  *  @param[in] h Handle.
  */
 void check::read(handle& h) {
-  char buffer[1024];
+  char buffer[16384];
   unsigned long rb(h.read(buffer, sizeof(buffer)));
   if (&h == &_err) {
     log::core()->debug("reading from process {}'s stdout", _child);
-    _stderr.append(buffer, rb);
+    _append(_stderr, buffer, rb);
   } else {
     log::core()->debug("reading from process {}'s stderr", _child);
-    _stdout.append(buffer, rb);
+    _append(_stdout, buffer, rb);
   }
 }
 
+/**
+ *  Process of the check was started, read its outputs.
+ *
+ *  @param[in] child  Process ID.
+ *  @param[in] out_fd Read end of the process' standard output.
+ *  @param[in] err_fd Read end of the process' error output.
+ */
+void check::start(pid_t child, int out_fd, int err_fd) {
+  // The check timed out before its worker started it.
+  if (!_cmd_id) {
+    log::core()->info("killing process {} of a check that timed out", child);
+    kill(child, SIGKILL);
+    ::close(out_fd);
+    ::close(err_fd);
+    return;
+  }
+
+  _child = child;
+  _out.set_fd(out_fd);
+  _err.set_fd(err_fd);
+
+  // Register with multiplexer. Memory files are read at exit only.
+  if (!_memfd) {
+    multiplexer::instance().reactor::add(&_err, this);
+    multiplexer::instance().reactor::add(&_out, this);
+  }
+}
+
+/**
+ *  The check runs in-process within a worker.
+ *
+ *  @param[in] worker Process ID of the worker.
+ */
+void check::start_in_process(pid_t worker) {
+  _child = worker;
+  _in_process = true;
+}
+
 /**
  *  Process termination callback.
  *
  *  @param[in] exit_code Process exit code.
  */
 void check::terminated(int exit_code) {
-  // Read possibly remaining data.
+  // Read possibly remaining data. The process is over and must not be
+  // killed if its outputs exceed their limit now.
   log::core()->debug("reading remaining data from process {}", _child);
-  try {
-    char buffer[1024];
-    unsigned long rb(_out.read(buffer, sizeof(buffer)));
-    while (rb != 0) {
-      _stdout.append(buffer, rb);
-      rb = _out.read(buffer, rb);
+  _child = (pid_t)-1;
+  if (_memfd) {
+    _read_file(_out, _stdout);
+    _read_file(_err, _stderr);
+  } else {
+    try {
+      char buffer[16384];
+      unsigned long rb(_out.read(buffer, sizeof(buffer)));
+      while (rb != 0) {
+        _append(_stdout, buffer, rb);
+        rb = _out.read(buffer, sizeof(buffer));
+      }
+    } catch (...) {
     }
-  } catch (...) {
-  }
-  try {
-    char buffer[1024];
-    unsigned long rb(_err.read(buffer, sizeof(buffer)));
-    while (rb != 0) {
-      _stderr.append(buffer, rb);
-      rb = _err.read(buffer, sizeof(buffer));
+    try {
+      char buffer[16384];
+      unsigned long rb(_err.read(buffer, sizeof(buffer)));
+      while (rb != 0) {
+        _append(_stderr, buffer, rb);
+        rb = _err.read(buffer, sizeof(buffer));
+      }
+    } catch (...) {
     }
-  } catch (...) {
   }
 
-  // Reset PID.
-  _child = (pid_t)-1;
+  // Mark truncated output. The check was killed, report it as
+  // unknown.
+  if (_stdout_truncated || _stderr_truncated) {
+    exit_code = 3;
+    if (_stdout_truncated)
+      _stdout.append(truncation_marker, sizeof(truncation_marker) - 1);
+    if (_stderr_truncated)
+      _stderr.append(truncation_marker, sizeof(truncation_marker) - 1);
+  }
 
   // Send check result.
   result r;
   r.set_command_id(_cmd_id);
   r.set_executed(true);
   r.set_exit_code(exit_code);
-  r.set_error(_stderr);
-  r.set_output(_stdout);
+  r.set_error(std::move(_stderr));
+  r.set_output(std::move(_stdout));
   _send_result_and_unregister(r);
 }
 
@@ -243,6 +367,54 @@ void check::write([[maybe_unused]] handle& h) {
  *                                     *
  **************************************/
 
+/**
+ *  Append data read from the process, within the output size limit.
+ *  The process is killed as soon as the limit is exceeded.
+ *
+ *  @param[in,out] data   Output stream.
+ *  @param[in]     buffer Data read.
+ *  @param[in]     size   Data size.
+ */
+void check::_append(std::string& data, char const* buffer, size_t size) {
+  if (!_max_output_size || data.size() + size <= _max_output_size) {
+    data.append(buffer, size);
+    return;
+  }
+
+  bool& truncated(&data == &_stdout ? _stdout_truncated : _stderr_truncated);
+  if (truncated)
+    return;
+  data.append(buffer, _max_output_size - data.size());
+  truncated = true;
+  log::core()->error(
+      "output of check {0} (pid={1}) exceeds {2} bytes, killing process",
+      _cmd_id, _child, _max_output_size);
+  if (_child > 0)
+    kill(_child, SIGKILL);
+}
+
+/**
+ *  Read a whole memory file output.
+ *
+ *  @param[in]     h    Memory file.
+ *  @param[in,out] data Output stream.
+ */
+void check::_read_file(pipe_handle& h, std::string& data) {
+  int fd(h.get_native_handle());
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) || st.st_size <= 0)
+    return;
+
+  // One more byte than the limit is enough to mark truncation.
+  size_t size(st.st_size);
+  if (_max_output_size && size > _max_output_size + 1)
+    size = _max_output_size + 1;
+  std::string buffer(size, '\0');
+  ssize_t rb(pread(fd, &buffer[0], size, 0));
+  if (rb > 0)
+    _append(data, buffer.data(), rb);
+}
+
 /**
  *  Send check result and unregister.
  *
@@ -255,19 +427,15 @@ void check::_send_result_and_unregister(result const& r) {
     _child = (pid_t)-1;
   }
 
-  // Remove timeout task.
-  if (_timeout) {
-    try {
-      multiplexer::instance().com::centreon::task_manager::remove(_timeout);
-    } catch (...) {
-    }
-    _timeout = 0;
-  }
+  // Disarm timeouts.
+  _timeout.cancel();
+  _final_timeout.cancel();
 
   // Check that we haven't already send a check result.
   if (_cmd_id) {
     // Unregister from multiplexer.
-    multiplexer::instance().handle_manager::remove(this);
+    multiplexer::instance().reactor::remove(&_err);
+    multiplexer::instance().reactor::remove(&_out);
 
     // Reset command ID.
     _cmd_id = 0;
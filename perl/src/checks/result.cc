@@ -18,6 +18,8 @@
 
 #include "com/centreon/connector/perl/checks/result.hh"
 
+#include <utility>
+
 using namespace com::centreon::connector::perl::checks;
 
 /**************************************
@@ -31,6 +33,22 @@ using namespace com::centreon::connector::perl::checks;
  */
 result::result() : _cmd_id(0), _executed(false), _exit_code(-1) {}
 
+/**
+ *  Move constructor.
+ *
+ *  @param[in] r Object to move.
+ */
+result::result(result&& r) noexcept = default;
+
+/**
+ *  Move assignment operator.
+ *
+ *  @param[in] r Object to move.
+ *
+ *  @return This object.
+ */
+result& result::operator=(result&& r) noexcept = default;
+
 /**
  *  Get the command ID.
  *
@@ -94,6 +112,15 @@ void result::set_error(std::string const& error) {
   _error = error;
 }
 
+/**
+ *  Set the error string.
+ *
+ *  @param[in] error Error string, moved into the result.
+ */
+void result::set_error(std::string&& error) noexcept {
+  _error = std::move(error);
+}
+
 /**
  *  Set the executed flag.
  *
@@ -121,3 +148,12 @@ void result::set_exit_code(int code) noexcept {
 void result::set_output(std::string const& output) {
   _output = output;
 }
+
+/**
+ *  Set the check output.
+ *
+ *  @param[in] output Check output, moved into the result.
+ */
+void result::set_output(std::string&& output) noexcept {
+  _output = std::move(output);
+}
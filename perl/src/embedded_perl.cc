@@ -17,17 +17,26 @@
 */
 
 
-#include "com/centreon/connector/perl/pipe_handle.hh"
 #include "com/centreon/exceptions/basic.hh"
 #include "com/centreon/connector/log.hh"
 #include "com/centreon/connector/perl/embedded_perl.hh"
 
+#include <dirent.h>
+#include <fcntl.h>
 #include <perl.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <chrono>
+#include <csignal>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <list>
+#include <set>
 
 using namespace com::centreon;
 using namespace com::centreon::connector::perl;
@@ -37,6 +46,12 @@ using namespace com::centreon::connector::perl;
 
 // Embedded Perl instance.
 static embedded_perl* _instance = nullptr;
+// Outputs of checks are written as soon as they are printed.
+bool embedded_perl::_autoflush = false;
+// File listing compiled scripts, compiled again at startup.
+std::string embedded_perl::_manifest;
+// Directory whose scripts are compiled at startup.
+std::string embedded_perl::_warm_up_dir;
 // Perl interpreter object.
 PerlInterpreter* my_perl(nullptr);
 
@@ -53,6 +68,8 @@ EXTERN_C void xs_init(pTHX);
  *  Embedded Perl destructor.
  */
 embedded_perl::~embedded_perl() {
+  close(_null_fd);
+
   // Clean only if within parent process.
   if (_self == getpid()) {
     // Clean Perl interpreter.
@@ -67,6 +84,62 @@ embedded_perl::~embedded_perl() {
   }
 }
 
+/**
+ *  Error on the watcher, scripts will not be compiled again.
+ *
+ *  @param[in] h Watcher.
+ */
+void embedded_perl::error(handle& h) {
+  (void)h;
+  log::core()->error("error on the watcher of Perl scripts");
+}
+
+/**
+ *  Forget compiled scripts that changed on disk, they will be compiled
+ *  again on their next run.
+ */
+void embedded_perl::expire_changed() {
+  alignas(inotify_event) char buffer[4096];
+  ssize_t rb;
+  while ((rb = ::read(_watcher.get_native_handle(), buffer,
+                      sizeof(buffer))) > 0) {
+    for (char const* ptr(buffer); ptr < buffer + rb;) {
+      inotify_event const* e(reinterpret_cast<inotify_event const*>(ptr));
+      ptr += sizeof(*e) + e->len;
+
+      // Events were lost, forget everything.
+      if (e->mask & IN_Q_OVERFLOW) {
+        log::core()->error("too many changes of Perl scripts, all of them "
+                           "will be compiled again");
+        while (!_parsed.empty()) {
+          // _expire() erases the entry, do not pass a reference to it.
+          std::string file(_parsed.begin()->first);
+          _expire(file);
+        }
+        continue;
+      }
+      auto it(_watches.find(e->wd));
+      if (it == _watches.end())
+        continue;
+      if (e->mask & IN_IGNORED)
+        _watches.erase(it);
+      else if (e->len)
+        for (std::string const& prefix : it->second)
+          _expire(prefix + e->name);
+    }
+  }
+}
+
+/**
+ *  Get the watcher of compiled scripts.
+ *
+ *  @return inotify handle, its descriptor is -1 if scripts are not
+ *          watched.
+ */
+pipe_handle& embedded_perl::get_watcher() noexcept {
+  return _watcher;
+}
+
 /**
  *  Get instance.
  *
@@ -92,78 +165,62 @@ void embedded_perl::load(int* argc,
     _instance = new embedded_perl(argc, argv, env, code);
 }
 
+/**
+ *  Scripts changed on disk.
+ *
+ *  @param[in] h Watcher.
+ */
+void embedded_perl::read(handle& h) {
+  (void)h;
+  expire_changed();
+}
+
+/**
+ *  Watch compiled scripts with a watcher of our own, in a forked
+ *  process that would otherwise share the events of its parent.
+ */
+void embedded_perl::renew_watcher() {
+  _watcher.close();
+  _watches.clear();
+  _open_watcher();
+  for (auto const& p : _parsed)
+    _watch(p.first);
+}
+
 /**
  *  Run a Perl script.
  *
- *  @param[in]  cmd Command to execute.
- *  @param[out] fds Process' file descriptors.
+ *  @param[in]  cmd   Command to execute.
+ *  @param[out] fds   Read ends of the process' standard output and
+ *                    error output.
+ *  @param[in]  memfd Outputs are written to memory files instead of
+ *                    pipes, they are read once the process exited.
  *
  *  @return Process ID.
  */
-pid_t embedded_perl::run(std::string const& cmd, int fds[3]) {
+pid_t embedded_perl::run(std::string const& cmd, int fds[2], bool memfd) {
   // Check arguments.
   if (!fds)
     throw basic_error() << "cannot run Perl script without "
                            "fetching process' descriptors";
 
-  // Extract arguments.
-  size_t pos(cmd.find(' '));
+  // Compile script.
   std::string args;
   std::string file;
-  if (pos != std::string::npos) {
-    file = cmd.substr(0, pos);
-    args = cmd.substr(pos + 1);
-  } else
-    file = cmd;
-  log::core()->debug("command {}", cmd);
-  log::core()->debug("  - file {}", file);
-  log::core()->debug("  - args {}", args);
-
-  // Check if file has already been compiled.
-  SV* handle;
-  umap<std::string, SV*>::const_iterator it(_parsed.find(file));
+  _split(cmd, file, args);
+  SV* handle(_compile(file));
   dSP;
-  if (it == _parsed.end()) {
-    // Compile Perl file.
-    {
-      log::core()->debug("parsing file {}", file);
-      char const* argv[3];
-      argv[0] = file.c_str();
-      argv[1] = "0";
-      argv[2] = nullptr;
-      if (call_argv("Embed::Persistent::eval_file", G_EVAL | G_SCALAR,
-                    (char**)argv) != 1)
-        throw basic_error() << "could not compile Perl script " << file;
-    }
-    SPAGAIN;
-    handle = POPs;
-    if (SvTRUE(ERRSV))
-      throw basic_error() << "Embedded Perl error: " << SvPV_nolen(ERRSV);
-
-    // Insert in parsed file list.
-    _parsed.insert(std::make_pair(file, handle));
-  }
-  // Already parsed.
-  else
-    handle = it->second;
 
-  // Open pipes.
-  int in_pipe[2];
+  // Open outputs. All descriptors of the connector are close-on-exec,
+  // commands run by plugins do not inherit them.
   int err_pipe[2];
   int out_pipe[2];
-  if (pipe(in_pipe)) {
+  if (_open_output(err_pipe, memfd, "stderr")) {
     char const* msg(strerror(errno));
     throw basic_error() << msg;
-  } else if (pipe(err_pipe)) {
-    char const* msg(strerror(errno));
-    close(in_pipe[0]);
-    close(in_pipe[1]);
-    throw basic_error() << msg;
   }
-  if (pipe(out_pipe)) {
+  if (_open_output(out_pipe, memfd, "stdout")) {
     char const* msg(strerror(errno));
-    close(in_pipe[0]);
-    close(in_pipe[1]);
     close(err_pipe[0]);
     close(err_pipe[1]);
     throw basic_error() << msg;
@@ -172,38 +229,28 @@ pid_t embedded_perl::run(std::string const& cmd, int fds[3]) {
   // Execute Perl file.
   pid_t child(fork());
   if (child > 0) {  // Parent
-    close(in_pipe[0]);
     close(err_pipe[1]);
     close(out_pipe[1]);
-    fds[0] = in_pipe[1];
-    fds[1] = out_pipe[0];
-    fds[2] = err_pipe[0];
+    fds[0] = out_pipe[0];
+    fds[1] = err_pipe[0];
   } else if (!child) {  // Child
-    // Close existing file descriptors.
-    try {
-      pipe_handle::close_all_handles();
-    } catch (std::exception const& e) {
-      std::cerr << "could not close all inherited FDs: " << e.what()
-                << std::endl;
-      exit(3);
-    } catch (...) {
-      std::cerr << "could not close all inherited FDs" << std::endl;
-      exit(3);
-    }
+    // Checks start with no blocked signal, whatever their launcher
+    // blocked.
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigprocmask(SIG_SETMASK, &mask, nullptr);
 
-    // Setup process.
-    close(in_pipe[1]);
+    // Setup process. Standard input is /dev/null, descriptors
+    // duplicated by dup2() are not close-on-exec.
     close(err_pipe[0]);
     close(out_pipe[0]);
-    if (dup2(in_pipe[0], STDIN_FILENO) < 0) {
+    if (dup2(_null_fd, STDIN_FILENO) < 0) {
       char const* msg(strerror(errno));
       std::cerr << "dup2 error: " << msg << std::endl;
-      close(in_pipe[0]);
       close(err_pipe[1]);
       close(out_pipe[1]);
       exit(3);
     }
-    close(in_pipe[0]);
     if (dup2(err_pipe[1], STDERR_FILENO) < 0) {
       char const* msg(strerror(errno));
       std::cerr << "dup2 error: " << msg << std::endl;
@@ -227,6 +274,7 @@ pid_t embedded_perl::run(std::string const& cmd, int fds[3]) {
     XPUSHs(sv_2mortal(newSVpv(file.c_str(), 0)));
     XPUSHs(handle);
     XPUSHs(sv_2mortal(newSVpv(args.c_str(), 0)));
+    XPUSHs(_autoflush ? &PL_sv_yes : &PL_sv_no);
     PUTBACK;
     call_pv("Embed::Persistent::run_file", G_DISCARD);
     std::cerr << "error while executing Perl script '" << file
@@ -235,8 +283,6 @@ pid_t embedded_perl::run(std::string const& cmd, int fds[3]) {
     abort();
   } else if (child < 0) {  // Error
     char const* msg(strerror(errno));
-    close(in_pipe[0]);
-    close(in_pipe[1]);
     close(out_pipe[0]);
     close(out_pipe[1]);
     close(err_pipe[0]);
@@ -247,6 +293,119 @@ pid_t embedded_perl::run(std::string const& cmd, int fds[3]) {
   return child;
 }
 
+/**
+ *  Check if a script is marked to run in-process. It is compiled if
+ *  it was not already.
+ *
+ *  @param[in] cmd Command to execute.
+ *
+ *  @return true if the script has the '# nagios: +epn' pragma.
+ */
+bool embedded_perl::is_in_process(std::string const& cmd) {
+  std::string args;
+  std::string file;
+  _split(cmd, file, args);
+  _compile(file);
+
+  dSP;
+  ENTER;
+  SAVETMPS;
+  PUSHMARK(SP);
+  XPUSHs(sv_2mortal(newSVpv(file.c_str(), 0)));
+  PUTBACK;
+  int count(call_pv("Embed::Persistent::in_process", G_SCALAR));
+  SPAGAIN;
+  bool retval(count == 1 && SvTRUE(POPs));
+  PUTBACK;
+  FREETMPS;
+  LEAVE;
+  return retval;
+}
+
+/**
+ *  Run a Perl script within the current process, without forking.
+ *  Its outputs are captured in memory, exit() is caught and a
+ *  watchdog interrupts it on timeout.
+ *
+ *  @param[in]  cmd        Command to execute.
+ *  @param[in]  timeout_ms Timeout in milliseconds.
+ *  @param[out] out        Standard output of the script.
+ *  @param[out] err        Error output of the script.
+ *
+ *  @return Exit code of the script, -1 on timeout.
+ */
+int embedded_perl::run_in_process(std::string const& cmd,
+                                  unsigned int timeout_ms,
+                                  std::string& out,
+                                  std::string& err) {
+  std::string args;
+  std::string file;
+  _split(cmd, file, args);
+  SV* handle(_compile(file));
+
+  dSP;
+  ENTER;
+  SAVETMPS;
+  PUSHMARK(SP);
+  XPUSHs(sv_2mortal(newSVpv(file.c_str(), 0)));
+  XPUSHs(handle);
+  XPUSHs(sv_2mortal(newSVpv(args.c_str(), 0)));
+  XPUSHs(sv_2mortal(newSVnv(timeout_ms / 1000.0)));
+  PUTBACK;
+  int count(call_pv("Embed::Persistent::run_file_in_process",
+                    G_ARRAY | G_EVAL));
+  SPAGAIN;
+  if (count != 3 || SvTRUE(ERRSV)) {
+    std::string msg(SvPV_nolen(ERRSV));
+    while (count-- > 0)
+      POPs;
+    PUTBACK;
+    FREETMPS;
+    LEAVE;
+    throw basic_error() << "could not run Perl script " << file << ": "
+                        << msg;
+  }
+  // SvPV() evaluates its argument more than once.
+  SV* err_sv(POPs);
+  SV* out_sv(POPs);
+  STRLEN len;
+  char const* data(SvPV(err_sv, len));
+  err.assign(data, len);
+  data = SvPV(out_sv, len);
+  out.assign(data, len);
+  int retval(POPi);
+  PUTBACK;
+  FREETMPS;
+  LEAVE;
+  return retval;
+}
+
+/**
+ *  Set whether checks write their outputs as soon as they print them,
+ *  instead of once they are over. This must be set before forking
+ *  workers.
+ *
+ *  @param[in] enable true to stream outputs.
+ */
+void embedded_perl::set_autoflush(bool enable) {
+  _autoflush = enable;
+}
+
+/**
+ *  Set scripts compiled by warm_up(). This must be set before forking
+ *  workers.
+ *
+ *  @param[in] manifest  File where compiled scripts are recorded,
+ *                       empty for none.
+ *  @param[in] directory Directory whose Perl scripts are compiled,
+ *                       empty for none.
+ */
+void embedded_perl::set_warm_up(std::string const& manifest,
+                                std::string const& directory) {
+  _manifest = manifest;
+  _warm_up_dir = directory;
+}
+
 /**
  *  Unload Embedded Perl.
  */
@@ -255,12 +414,345 @@ void embedded_perl::unload() {
   _instance = nullptr;
 }
 
+/**
+ *  Compile the scripts recorded in the manifest and those of the
+ *  warm-up directory, so that processes forked afterwards share them
+ *  and first checks do not wait for them. The manifest is then
+ *  rewritten with the scripts actually compiled.
+ */
+void embedded_perl::warm_up() {
+  if (_manifest.empty() && _warm_up_dir.empty())
+    return;
+
+  // Scripts compiled by the last run.
+  std::vector<std::string> files;
+  std::set<std::string> known;
+  if (!_manifest.empty()) {
+    std::ifstream ifs(_manifest);
+    std::string line;
+    while (std::getline(ifs, line))
+      if (!line.empty() && known.insert(line).second)
+        files.push_back(line);
+  }
+
+  // Scripts of the warm-up directory.
+  if (!_warm_up_dir.empty()) {
+    DIR* dir(opendir(_warm_up_dir.c_str()));
+    if (!dir) {
+      char const* msg(strerror(errno));
+      log::core()->error("could not open warm-up directory {0}: {1}",
+                         _warm_up_dir, msg);
+    } else {
+      std::string prefix(_warm_up_dir);
+      while (!prefix.empty() && prefix.back() == '/')
+        prefix.pop_back();
+      prefix.push_back('/');
+      std::vector<std::string> entries;
+      while (dirent* e = readdir(dir))
+        if (e->d_name[0] != '.')
+          entries.push_back(prefix + e->d_name);
+      closedir(dir);
+      std::sort(entries.begin(), entries.end());
+      for (std::string const& path : entries)
+        if (!known.count(path) && _is_perl_script(path)) {
+          known.insert(path);
+          files.push_back(path);
+        }
+    }
+  }
+
+  // Compile them.
+  log::core()->info("warming up {} Perl scripts", files.size());
+  _warming_up = true;
+  unsigned int failed(0);
+  auto start(std::chrono::steady_clock::now());
+  for (std::string const& file : files) {
+    auto begin(std::chrono::steady_clock::now());
+    try {
+      _compile(file);
+      std::chrono::duration<double, std::milli> elapsed(
+          std::chrono::steady_clock::now() - begin);
+      log::core()->info("compiled Perl script {0} in {1:.1f} ms", file,
+                        elapsed.count());
+    } catch (std::exception const& e) {
+      ++failed;
+      log::core()->error("could not warm up Perl script {0}: {1}", file,
+                         e.what());
+    }
+  }
+  _warming_up = false;
+  std::chrono::duration<double, std::milli> elapsed(
+      std::chrono::steady_clock::now() - start);
+  log::core()->info(
+      "warm-up compiled {0} Perl scripts in {1:.1f} ms, {2} failed",
+      files.size() - failed, elapsed.count(), failed);
+
+  _write_manifest();
+}
+
+/**
+ *  The watcher is always read.
+ *
+ *  @return true.
+ */
+bool embedded_perl::want_read([[maybe_unused]] handle& h) {
+  return true;
+}
+
 /**************************************
  *                                     *
  *           Private Methods           *
  *                                     *
  **************************************/
 
+/**
+ *  Compile a Perl script, unless it already was.
+ *
+ *  @param[in] file Script path.
+ *
+ *  @return Handle of the compiled script.
+ */
+SV* embedded_perl::_compile(std::string const& file) {
+  // Check if file has already been compiled.
+  SV* handle;
+  umap<std::string, SV*>::const_iterator it(_parsed.find(file));
+  dSP;
+  if (it == _parsed.end()) {
+    // A script that failed to compile fails the same way until it
+    // changes, it is not read again.
+    failure id;
+    _identify(file, id);
+    auto failed(_failed.find(file));
+    if (failed != _failed.end()) {
+      failure const& f(failed->second);
+      if (f.exists == id.exists && f.dev == id.dev && f.ino == id.ino &&
+          f.size == id.size && f.mtime.tv_sec == id.mtime.tv_sec &&
+          f.mtime.tv_nsec == id.mtime.tv_nsec)
+        throw basic_error() << f.error;
+      _failed.erase(failed);
+    }
+
+    // Compile Perl file.
+    {
+      log::core()->debug("parsing file {}", file);
+      char const* argv[3];
+      argv[0] = file.c_str();
+      argv[1] = "0";
+      argv[2] = nullptr;
+      if (call_argv("Embed::Persistent::eval_file", G_EVAL | G_SCALAR,
+                    (char**)argv) != 1) {
+        id.error = "could not compile Perl script " + file;
+        _failed[file] = id;
+        throw basic_error() << id.error;
+      }
+    }
+    SPAGAIN;
+    handle = POPs;
+    PUTBACK;
+    if (SvTRUE(ERRSV)) {
+      id.error = std::string("Embedded Perl error: ") + SvPV_nolen(ERRSV);
+      _failed[file] = id;
+      throw basic_error() << id.error;
+    }
+
+    // Insert in parsed file list.
+    _parsed.insert(std::make_pair(file, handle));
+    _watch(file);
+    _record(file);
+  }
+  // Already parsed.
+  else
+    handle = it->second;
+
+  return handle;
+}
+
+/**
+ *  Forget a compiled script.
+ *
+ *  @param[in] file Script path.
+ */
+void embedded_perl::_expire(std::string const& file) {
+  _failed.erase(file);
+  if (!_parsed.erase(file))
+    return;
+  log::core()->info("Perl script {} changed, it will be compiled again",
+                    file);
+  char const* argv[2];
+  argv[0] = file.c_str();
+  argv[1] = nullptr;
+  call_argv("Embed::Persistent::expire_file", G_DISCARD | G_EVAL,
+            (char**)argv);
+}
+
+/**
+ *  Get what identifies a version of a script.
+ *
+ *  @param[in]  file Script path.
+ *  @param[out] id   Identity of the script, without error.
+ */
+void embedded_perl::_identify(std::string const& file, failure& id) {
+  struct stat st;
+  id.exists = !stat(file.c_str(), &st);
+  id.dev = id.exists ? st.st_dev : 0;
+  id.ino = id.exists ? st.st_ino : 0;
+  id.mtime = id.exists ? st.st_mtim : timespec();
+  id.size = id.exists ? st.st_size : 0;
+}
+
+/**
+ *  Check whether a file of the warm-up directory is a Perl script,
+ *  from its extension or its shebang line.
+ *
+ *  @param[in] file File path.
+ *
+ *  @return true if the file looks like a Perl script.
+ */
+bool embedded_perl::_is_perl_script(std::string const& file) {
+  if (file.size() > 3 && !file.compare(file.size() - 3, 3, ".pl"))
+    return true;
+  int fd(open(file.c_str(), O_RDONLY | O_CLOEXEC));
+  if (fd < 0)
+    return false;
+  char buffer[128];
+  ssize_t rb(::read(fd, buffer, sizeof(buffer)));
+  close(fd);
+  if (rb < 2 || buffer[0] != '#' || buffer[1] != '!')
+    return false;
+  std::string line(buffer, rb);
+  return line.substr(0, line.find('\n')).find("perl") != std::string::npos;
+}
+
+/**
+ *  Open an output of a process, like pipe2() would. A memory file is
+ *  opened twice so that its ends can be closed like those of a pipe.
+ *
+ *  @param[out] fds   Read end and write end.
+ *  @param[in]  memfd Use a memory file instead of a pipe.
+ *  @param[in]  name  Name of the memory file.
+ *
+ *  @return 0 on success, -1 on error.
+ */
+int embedded_perl::_open_output(int fds[2], bool memfd, char const* name) {
+  if (!memfd)
+    return pipe2(fds, O_CLOEXEC);
+  fds[0] = memfd_create(name, MFD_CLOEXEC);
+  if (fds[0] < 0)
+    return -1;
+  fds[1] = fcntl(fds[0], F_DUPFD_CLOEXEC, 0);
+  if (fds[1] < 0) {
+    int error(errno);
+    close(fds[0]);
+    errno = error;
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ *  Open the watcher of compiled scripts. Scripts are cached until
+ *  restart if inotify is not available.
+ */
+void embedded_perl::_open_watcher() {
+  int fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC));
+  if (fd < 0) {
+    char const* msg(strerror(errno));
+    log::core()->error("could not watch Perl scripts, changes will be "
+                       "ignored until restart: {}", msg);
+    return;
+  }
+  _watcher.set_fd(fd);
+}
+
+/**
+ *  Append a newly compiled script to the manifest.
+ *
+ *  @param[in] file Script path.
+ */
+void embedded_perl::_record(std::string const& file) {
+  if (_manifest.empty() || _warming_up)
+    return;
+  int fd(open(_manifest.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC,
+              0644));
+  std::string line(file + "\n");
+  if (fd < 0 || ::write(fd, line.data(), line.size()) < 0) {
+    char const* msg(strerror(errno));
+    log::core()->error("could not record Perl script {0} in {1}: {2}", file,
+                       _manifest, msg);
+  }
+  if (fd >= 0)
+    close(fd);
+}
+
+/**
+ *  Split a command line into script path and arguments.
+ *
+ *  @param[in]  cmd  Command line.
+ *  @param[out] file Script path.
+ *  @param[out] args Script arguments.
+ */
+void embedded_perl::_split(std::string const& cmd,
+                           std::string& file,
+                           std::string& args) {
+  size_t pos(cmd.find(' '));
+  if (pos != std::string::npos) {
+    file = cmd.substr(0, pos);
+    args = cmd.substr(pos + 1);
+  } else {
+    file = cmd;
+    args.clear();
+  }
+  log::core()->debug("command {}", cmd);
+  log::core()->debug("  - file {}", file);
+  log::core()->debug("  - args {}", args);
+}
+
+/**
+ *  Watch the directory of a compiled script. Its entries are matched
+ *  with the directory prefix of the script as it was run.
+ *
+ *  @param[in] file Script path.
+ */
+void embedded_perl::_watch(std::string const& file) {
+  if (_watcher.get_native_handle() < 0)
+    return;
+  std::string prefix(file.substr(0, file.rfind('/') + 1));
+  int wd(inotify_add_watch(_watcher.get_native_handle(),
+                           (prefix.empty() ? "." : prefix.c_str()),
+                           IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_TO |
+                               IN_ONLYDIR));
+  if (wd < 0) {
+    char const* msg(strerror(errno));
+    log::core()->error("could not watch directory of Perl script {0}: {1}",
+                       file, msg);
+    return;
+  }
+  std::vector<std::string>& prefixes(_watches[wd]);
+  if (std::find(prefixes.begin(), prefixes.end(), prefix) == prefixes.end())
+    prefixes.push_back(prefix);
+}
+
+/**
+ *  Rewrite the manifest with the scripts compiled so far.
+ */
+void embedded_perl::_write_manifest() {
+  if (_manifest.empty())
+    return;
+  std::string tmp(_manifest + "." + std::to_string(getpid()));
+  {
+    std::ofstream ofs(tmp, std::ios::trunc);
+    for (auto const& p : _parsed)
+      ofs << p.first << "\n";
+    ofs.close();
+    if (ofs && !rename(tmp.c_str(), _manifest.c_str()))
+      return;
+  }
+  char const* msg(strerror(errno));
+  log::core()->error("could not write warm-up manifest {0}: {1}", _manifest,
+                     msg);
+  unlink(tmp.c_str());
+}
+
 /**
  *  Constructor.
  *
@@ -275,6 +767,7 @@ embedded_perl::embedded_perl([[maybe_unused]] int* argc,
                              char const* code) {
   // Set original PID.
   _self = getpid();
+  _warming_up = false;
   log::core()->debug("self PID is {}", _self);
 
   // Temporary script path.
@@ -300,7 +793,7 @@ embedded_perl::embedded_perl([[maybe_unused]] int* argc,
       char const* data(*it);
       size_t len(strlen(data));
       while (len > 0) {
-        ssize_t wb(write(script_fd, data, len));
+        ssize_t wb(::write(script_fd, data, len));
         if (wb <= 0) {
           char const* msg(strerror(errno));
           close(script_fd);
@@ -337,4 +830,13 @@ embedded_perl::embedded_perl([[maybe_unused]] int* argc,
   }
   PL_exit_flags |= PERL_EXIT_DESTRUCT_END;
   perl_run(my_perl);
+
+  // Standard input of checks.
+  _null_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+  if (_null_fd < 0) {
+    char const* msg(strerror(errno));
+    throw basic_error() << "could not open /dev/null: " << msg;
+  }
+
+  _open_watcher();
 }
@@ -107,14 +107,23 @@ int main(int argc, char** argv, char** env) {
 
       signal(SIGTERM, term_handler);
 
-      // Load Embedded Perl.
-      embedded_perl::load(&argc, &argv, &env,
-                          (opts.get_argument("code").get_is_set()
-                               ? opts.get_argument("code").get_value().c_str()
-                               : nullptr));
+      // Load Embedded Perl, unless only workers should.
+      embedded_perl::set_autoflush(opts.get_argument("autoflush").get_is_set());
+      embedded_perl::set_warm_up(
+          (opts.get_argument("warm-up-file").get_is_set()
+               ? opts.get_argument("warm-up-file").get_value()
+               : std::string()),
+          (opts.get_argument("warm-up-dir").get_is_set()
+               ? opts.get_argument("warm-up-dir").get_value()
+               : std::string()));
+      if (!opts.get_argument("zygote").get_is_set())
+        embedded_perl::load(&argc, &argv, &env,
+                            (opts.get_argument("code").get_is_set()
+                                 ? opts.get_argument("code").get_value().c_str()
+                                 : nullptr));
 
       // Program policy.
-      policy p;
+      policy p(opts);
       retval = (p.run() ? EXIT_SUCCESS : EXIT_FAILURE);
     }
   } catch (std::exception const& e) {
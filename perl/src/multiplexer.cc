@@ -61,4 +61,4 @@ void multiplexer::unload() {
 /**
  *  Default constructor.
  */
-multiplexer::multiplexer() : com::centreon::handle_manager(this) {}
+multiplexer::multiplexer() : com::centreon::connector::reactor(this, this) {}
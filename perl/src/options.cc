@@ -17,11 +17,18 @@
 */
 
 #include "com/centreon/connector/perl/options.hh"
+#include <cstdlib>
+#include <limits>
 #include <sstream>
+#include "com/centreon/exceptions/basic.hh"
 
 using namespace com::centreon::connector::perl;
 
 // Options descriptions.
+static char const* const autoflush_description =
+    "Write outputs of checks as soon as they print them, for plugins "
+    "relying on streaming. By default they are written once checks "
+    "are over.";
 static char const* const code_description =
     "Argument is some Perl code that will be executed by the embedded "
     "interpreter.";
@@ -32,6 +39,36 @@ static char const* const version_description =
     "Print software version and exit.";
 static char const* const log_file_description =
     "Specifies the log file (default: stderr).";
+static char const* const max_output_size_description =
+    "Maximum number of bytes kept from each output stream of a check. "
+    "Checks exceeding it are killed and their output is truncated "
+    "(default: 0, unlimited).";
+static char const* const workers_description =
+    "Number of worker processes forked once Perl is loaded that start "
+    "checks in place of the connector (default: 0, checks are forked by "
+    "the connector itself).";
+static char const* const zygote_description =
+    "Do not load Perl in the connector, only in its worker processes. "
+    "The connector stays small and its event loop never pays for "
+    "forking the interpreter (implies --workers 1 if not set).";
+static char const* const in_process_description =
+    "Run scripts marked with '# nagios: +epn' within worker processes, "
+    "without forking. Their outputs are captured in memory and exit() "
+    "is caught. A worker running such a script starts no other check "
+    "meanwhile (implies --workers 2 if not set).";
+static char const* const memfd_description =
+    "Capture outputs of checks in memory files read once the checks "
+    "exited, instead of pipes read while they run. The output size "
+    "limit then applies after their exit.";
+static char const* const warm_up_file_description =
+    "File where compiled scripts are recorded. They are compiled again "
+    "at startup, before reading orders and forking workers.";
+static char const* const warm_up_dir_description =
+    "Directory whose Perl scripts are compiled at startup, before "
+    "reading orders and forking workers.";
+static char const* const max_checks_per_worker_description =
+    "Number of checks after which a worker process is replaced "
+    "(default: 0, never).";
 
 /**************************************
  *                                     *
@@ -51,6 +88,29 @@ options::options() {
  */
 options::~options() noexcept {}
 
+/**
+ *  Get the value of a numeric argument.
+ *
+ *  @param[in] long_name     Argument long name.
+ *  @param[in] default_value Value returned if argument is not set.
+ *
+ *  @return Argument value.
+ */
+unsigned int options::get_unsigned(std::string const& long_name,
+                                   unsigned int default_value) const {
+  misc::argument const& arg(get_argument(long_name));
+  if (!arg.get_is_set())
+    return default_value;
+  std::string const& value(arg.get_value());
+  char* end(nullptr);
+  unsigned long retval(strtoul(value.c_str(), &end, 10));
+  if (value.empty() || *end || value[0] == '-' ||
+      retval > std::numeric_limits<unsigned int>::max())
+    throw basic_error() << "invalid value '" << value << "' for argument '"
+                        << long_name << "'";
+  return retval;
+}
+
 /**
  *  Get the help.
  */
@@ -60,7 +120,17 @@ std::string options::help() const {
       << "  --debug    " << debug_description << "\n"
       << "  --help     " << help_description << "\n"
       << "  --version  " << version_description << "\n"
-      << "  --code     " << code_description << "\n";
+      << "  --code     " << code_description << "\n"
+      << "  --max-output-size " << max_output_size_description << "\n"
+      << "  --workers  " << workers_description << "\n"
+      << "  --max-checks-per-worker " << max_checks_per_worker_description
+      << "\n"
+      << "  --zygote   " << zygote_description << "\n"
+      << "  --in-process " << in_process_description << "\n"
+      << "  --memfd    " << memfd_description << "\n"
+      << "  --autoflush " << autoflush_description << "\n"
+      << "  --warm-up-file " << warm_up_file_description << "\n"
+      << "  --warm-up-dir " << warm_up_dir_description << "\n";
   return oss.str();
 }
 
@@ -72,6 +142,11 @@ std::string options::help() const {
  */
 void options::parse(int argc, char* argv[]) {
   _parse_arguments(argc, argv);
+
+  // Validate numeric arguments.
+  get_unsigned("max-output-size");
+  get_unsigned("workers");
+  get_unsigned("max-checks-per-worker");
 }
 
 /**
@@ -132,4 +207,79 @@ void options::_init() {
     arg.set_description(log_file_description);
     arg.set_has_value(true);
   }
+
+  // Output size.
+  {
+    misc::argument& arg(_arguments['s']);
+    arg.set_name('s');
+    arg.set_long_name("max-output-size");
+    arg.set_description(max_output_size_description);
+    arg.set_has_value(true);
+  }
+
+  // Worker processes.
+  {
+    misc::argument& arg(_arguments['w']);
+    arg.set_name('w');
+    arg.set_long_name("workers");
+    arg.set_description(workers_description);
+    arg.set_has_value(true);
+  }
+
+  // Checks per worker process.
+  {
+    misc::argument& arg(_arguments['m']);
+    arg.set_name('m');
+    arg.set_long_name("max-checks-per-worker");
+    arg.set_description(max_checks_per_worker_description);
+    arg.set_has_value(true);
+  }
+
+  // Zygote mode.
+  {
+    misc::argument& arg(_arguments['z']);
+    arg.set_name('z');
+    arg.set_long_name("zygote");
+    arg.set_description(zygote_description);
+  }
+
+  // In-process execution.
+  {
+    misc::argument& arg(_arguments['i']);
+    arg.set_name('i');
+    arg.set_long_name("in-process");
+    arg.set_description(in_process_description);
+  }
+
+  // Outputs captured in memory files.
+  {
+    misc::argument& arg(_arguments['f']);
+    arg.set_name('f');
+    arg.set_long_name("memfd");
+    arg.set_description(memfd_description);
+  }
+
+  // Outputs written as soon as printed.
+  {
+    misc::argument& arg(_arguments['a']);
+    arg.set_name('a');
+    arg.set_long_name("autoflush");
+    arg.set_description(autoflush_description);
+  }
+
+  // Scripts compiled at startup.
+  {
+    misc::argument& arg(_arguments['u']);
+    arg.set_name('u');
+    arg.set_long_name("warm-up-file");
+    arg.set_description(warm_up_file_description);
+    arg.set_has_value(true);
+  }
+  {
+    misc::argument& arg(_arguments['r']);
+    arg.set_name('r');
+    arg.set_long_name("warm-up-dir");
+    arg.set_description(warm_up_dir_description);
+    arg.set_has_value(true);
+  }
 }
@@ -66,7 +66,7 @@ void parser::listen(listener* l) noexcept {
 void parser::read(handle& h) {
   // Read data.
   log::core()->debug("reading data for parsing");
-  char buffer[4096];
+  char buffer[65536];
   unsigned long rb(h.read(buffer, sizeof(buffer)));
   log::core()->debug("read {} bytes from handle", rb);
 
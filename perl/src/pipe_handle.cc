@@ -22,8 +22,6 @@
 
 #include <cerrno>
 #include <cstring>
-#include <mutex>
-#include <set>
 
 #include "com/centreon/connector/log.hh"
 #include "com/centreon/exceptions/basic.hh"
@@ -32,15 +30,6 @@ using namespace com::centreon;
 using namespace com::centreon::connector;
 using namespace com::centreon::connector::perl;
 
-/**************************************
- *                                     *
- *           Local Objects             *
- *                                     *
- **************************************/
-
-static std::multiset<int> gl_fds;
-static std::mutex gl_fdsm;
-
 /**************************************
  *                                     *
  *           Public Methods            *
@@ -68,12 +57,6 @@ pipe_handle::~pipe_handle() noexcept {
  */
 void pipe_handle::close() noexcept {
   if (_fd >= 0) {
-    {
-      std::lock_guard<std::mutex> lock(gl_fdsm);
-      auto it = gl_fds.find(_fd);
-      if (it != gl_fds.end())
-        gl_fds.erase(it);
-    }
     if (::close(_fd) != 0) {
       char const* msg(strerror(errno));
       log::core()->error("could not close pipe FD: {}", msg);
@@ -82,25 +65,6 @@ void pipe_handle::close() noexcept {
   }
 }
 
-/**
- *  Close all handles.
- */
-void pipe_handle::close_all_handles() {
-  std::lock_guard<std::mutex> lock(gl_fdsm);
-  for (auto it(gl_fds.begin()), end(gl_fds.end()); it != end; ++it) {
-    int retval;
-    do {
-      retval = ::close(*it);
-    } while ((retval != 0) && (EINTR == errno));
-    if (retval != 0) {
-      char const* msg(strerror(errno));
-      gl_fds.erase(gl_fds.begin(), it);
-      throw basic_error() << msg;
-    }
-  }
-  gl_fds.clear();
-}
-
 /**
  *  Get the native handle associated with this pipe handle.
  *
@@ -135,10 +99,6 @@ unsigned long pipe_handle::read(void* data, unsigned long size) {
 void pipe_handle::set_fd(int fd) {
   close();
   _fd = fd;
-  if (_fd >= 0) {
-    std::lock_guard<std::mutex> lock(gl_fdsm);
-    gl_fds.insert(fd);
-  }
 }
 
 /**
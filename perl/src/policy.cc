@@ -20,16 +20,15 @@
 
 #include <sys/wait.h>
 
-#include <cerrno>
 #include <cstdio>
 #include <cstdlib>
-#include <cstring>
 #include <memory>
 
 #include "com/centreon/connector/log.hh"
 #include "com/centreon/connector/perl/checks/check.hh"
+#include "com/centreon/connector/perl/embedded_perl.hh"
 #include "com/centreon/connector/perl/multiplexer.hh"
-#include "com/centreon/exceptions/basic.hh"
+#include "com/centreon/connector/perl/options.hh"
 
 using namespace com::centreon;
 using namespace com::centreon::connector;
@@ -45,17 +44,55 @@ extern volatile bool should_exit;
  **************************************/
 
 /**
- *  Default constructor.
+ *  Constructor.
+ *
+ *  @param[in] opts Program options.
  */
-policy::policy() : _sin(stdin), _sout(stdout) {
+policy::policy(options const& opts)
+    : _max_output_size(opts.get_unsigned("max-output-size")),
+      _memfd(opts.get_argument("memfd").get_is_set()),
+      _reaper([this](pid_t pid, int status) { _on_exit(pid, status); }),
+      _sin(stdin),
+      _sout(stdout) {
   // Send information back.
-  multiplexer::instance().handle_manager::add(&_sout, &_reporter);
+  multiplexer::instance().reactor::add(&_sout, &_reporter);
+
+  // Fork workers now that Perl is loaded, or that they will load it
+  // themselves in zygote mode.
+  bool zygote(opts.get_argument("zygote").get_is_set());
+
+  // Compile known scripts before reading orders, and before forking
+  // workers so that they share them.
+  if (!zygote)
+    embedded_perl::instance().warm_up();
+  bool in_process(opts.get_argument("in-process").get_is_set());
+  unsigned int workers(opts.get_unsigned("workers"));
+  // A worker running a script in-process starts no other check, a
+  // second one keeps checks going.
+  if (in_process && !workers)
+    workers = 2;
+  else if (zygote && !workers)
+    workers = 1;
+  if (workers)
+    _workers.reset(new worker_pool(
+        _reaper, workers, opts.get_unsigned("max-checks-per-worker"), zygote,
+        (opts.get_argument("code").get_is_set()
+             ? opts.get_argument("code").get_value()
+             : std::string()),
+        in_process, _memfd));
+  else {
+    // Scripts are compiled here, watch their changes.
+    pipe_handle& watcher(embedded_perl::instance().get_watcher());
+    if (watcher.get_native_handle() >= 0)
+      multiplexer::instance().reactor::add(&watcher,
+                                           &embedded_perl::instance());
+  }
 
   // Listen orders.
   _parser.listen(this);
 
   // Parser listens stdin.
-  multiplexer::instance().handle_manager::add(&_sin, &_parser);
+  multiplexer::instance().reactor::add(&_sin, &_parser);
 }
 
 /**
@@ -64,8 +101,11 @@ policy::policy() : _sin(stdin), _sout(stdout) {
 policy::~policy() throw() {
   // Remove from multiplexer.
   try {
-    multiplexer::instance().handle_manager::remove(&_sin);
-    multiplexer::instance().handle_manager::remove(&_sout);
+    multiplexer::instance().reactor::remove(&_sin);
+    multiplexer::instance().reactor::remove(&_sout);
+    if (!_workers)
+      multiplexer::instance().reactor::remove(
+          &embedded_perl::instance().get_watcher());
   } catch (...) {
   }
 
@@ -77,6 +117,7 @@ policy::~policy() throw() {
     delete it->second;
   }
   _checks.clear();
+  _workers.reset();
 }
 
 /**
@@ -106,13 +147,33 @@ void policy::on_error() {
 void policy::on_execute(unsigned long long cmd_id,
                         const timestamp& timeout,
                         std::string const& cmd) {
-  std::unique_ptr<checks::check> chk(new checks::check);
+  std::unique_ptr<checks::check> chk(
+      new checks::check(_max_output_size, _memfd));
   chk->listen(this);
   try {
-    pid_t child(chk->execute(cmd_id, cmd, timeout));
-    _checks[child] = chk.release();
+    if (_workers)
+      _workers->execute(cmd_id, cmd, timeout, std::move(chk));
+    else {
+      pid_t child(chk->execute(cmd_id, cmd, timeout));
+      checks::check* running(chk.release());
+      _checks[child] = running;
+      try {
+        _reaper.watch(child);
+      } catch (std::exception const& e) {
+        // The check kills its process and sends its result, the
+        // process is waited here as nothing else would.
+        log::core()->error("could not watch process {0} of check {1}: {2}",
+                           child, cmd_id, e.what());
+        _checks.erase(child);
+        delete running;
+        waitpid(child, nullptr, 0);
+      }
+    }
   } catch (std::exception const& e) {
     log::core()->info("execution of check {0} failed {1}", cmd_id, e.what());
+    // A single result is sent, the check must not send its own.
+    if (chk)
+      chk->listen(nullptr);
     checks::result r;
     r.set_command_id(cmd_id);
     on_result(r);
@@ -126,7 +187,7 @@ void policy::on_quit() {
   // Exiting.
   log::core()->info("quit request received");
   should_exit = true;
-  multiplexer::instance().handle_manager::remove(&_sin);
+  multiplexer::instance().reactor::remove(&_sin);
 }
 
 /**
@@ -141,6 +202,7 @@ void policy::on_result(checks::result const& r) {
 
   // Send check result back to monitoring engine.
   _reporter.send_result(r);
+  multiplexer::instance().reactor::update(&_sout);
 }
 
 /**
@@ -150,6 +212,7 @@ void policy::on_version() {
   // Report version 1.0.
   log::core()->info("monitoring engine requested protocol version, sending 1.0");
   _reporter.send_version(1, 0);
+  multiplexer::instance().reactor::update(&_sout);
 }
 
 /**
@@ -161,38 +224,10 @@ bool policy::run() {
   // No error occurred yet.
   _error = false;
 
-  while (!should_exit || !_checks.empty()) {
-    // Run multiplexer.
+  while (!should_exit || !_checks.empty() ||
+         (_workers && _workers->get_checks_count())) {
+    // Run multiplexer, children termination is reported as it happens.
     multiplexer::instance().multiplex();
-
-    // Is there some terminated child ?
-    int status;
-    pid_t child(waitpid(0, &status, WNOHANG));
-    while (child != 0 && child != (pid_t)-1) {
-      // Handle process termination.
-      log::core()->info("process {0} exited with status {1}", status);
-      std::map<pid_t, checks::check*>::iterator it;
-      it = _checks.find(child);
-      if (it != _checks.end()) {
-        std::unique_ptr<checks::check> chk(it->second);
-        _checks.erase(it);
-        if (WIFSIGNALED(status)) {
-          log::core()->error("process {0} exited because of a signal {1}", child, WTERMSIG(status));
-        }
-
-        chk->terminated(WIFEXITED(status) ? WEXITSTATUS(status) : -1);
-      }
-      log::core()->debug("{} checks still running", _checks.size());
-
-      // Is there any other terminated child ?
-      child = waitpid(0, &status, WNOHANG);
-    }
-
-    // Check for error.
-    if (child == (pid_t)-1 && errno != ECHILD) {
-      char const* msg(strerror(errno));
-      throw basic_error() << "waitpid failed: " << msg;
-    }
   }
 
   // Run as long as some data remains.
@@ -202,3 +237,31 @@ bool policy::run() {
 
   return !_error;
 }
+
+/**************************************
+ *                                     *
+ *           Private Methods           *
+ *                                     *
+ **************************************/
+
+/**
+ *  A child process terminated.
+ *
+ *  @param[in] pid    Process ID.
+ *  @param[in] status Wait status.
+ */
+void policy::_on_exit(pid_t pid, int status) {
+  log::core()->info("process {0} exited with status {1}", pid, status);
+  auto it(_checks.find(pid));
+  if (it != _checks.end()) {
+    std::unique_ptr<checks::check> chk(it->second);
+    _checks.erase(it);
+    if (WIFSIGNALED(status)) {
+      log::core()->error("process {0} exited because of a signal {1}", pid,
+                         WTERMSIG(status));
+    }
+
+    chk->terminated(WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+  }
+  log::core()->debug("{} checks still running", _checks.size());
+}
@@ -0,0 +1,236 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#include "com/centreon/connector/perl/reaper.hh"
+
+#include <sys/resource.h>
+#include <sys/signalfd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <vector>
+
+#include "com/centreon/connector/log.hh"
+#include "com/centreon/connector/perl/multiplexer.hh"
+#include "com/centreon/exceptions/basic.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::connector;
+using namespace com::centreon::connector::perl;
+
+/**************************************
+ *                                     *
+ *           Local Objects             *
+ *                                     *
+ **************************************/
+
+/**
+ *  Open a pidfd, glibc may not provide pidfd_open().
+ *
+ *  @param[in] pid Process ID.
+ *
+ *  @return File descriptor, -1 on error.
+ */
+static int open_pidfd(pid_t pid) {
+#ifdef SYS_pidfd_open
+  return syscall(SYS_pidfd_open, pid, 0);
+#else
+  (void)pid;
+  errno = ENOSYS;
+  return -1;
+#endif  // SYS_pidfd_open
+}
+
+/**************************************
+ *                                     *
+ *           Public Methods            *
+ *                                     *
+ **************************************/
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] callback Called with the process ID and the wait status
+ *                      of each watched process that terminates.
+ */
+reaper::reaper(std::function<void(pid_t, int)> callback)
+    : _callback(callback) {
+  // Probe pidfd support on ourselves.
+  int fd(open_pidfd(getpid()));
+  if (fd >= 0) {
+    ::close(fd);
+    return;
+  }
+
+  // Fallback to SIGCHLD, blocked so that it is queued to the signalfd.
+  char const* msg(strerror(errno));
+  log::core()->info("pidfd not available ({}), watching SIGCHLD instead",
+                    msg);
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGCHLD);
+  sigprocmask(SIG_BLOCK, &mask, nullptr);
+  fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+  if (fd < 0) {
+    msg = strerror(errno);
+    throw basic_error() << "could not create signalfd: " << msg;
+  }
+  _sigchld.reset(new pipe_handle(fd));
+  multiplexer::instance().reactor::add(_sigchld.get(), this);
+}
+
+/**
+ *  Destructor.
+ */
+reaper::~reaper() noexcept {
+  try {
+    for (auto& p : _pids)
+      if (p.second)
+        multiplexer::instance().reactor::remove(p.second.get());
+    if (_sigchld)
+      multiplexer::instance().reactor::remove(_sigchld.get());
+  } catch (...) {
+  }
+}
+
+/**
+ *  Error occurred on a pidfd or on the signalfd, look for terminated
+ *  processes anyway.
+ *
+ *  @param[in] h Handle.
+ */
+void reaper::error(handle& h) {
+  read(h);
+}
+
+/**
+ *  A watched process terminated.
+ *
+ *  @param[in] h pidfd of the process, or the signalfd.
+ */
+void reaper::read(handle& h) {
+  if (_sigchld && &h == _sigchld.get()) {
+    // Signals are merged, any watched process may be over.
+    signalfd_siginfo si;
+    while (::read(h.get_native_handle(), &si, sizeof(si)) > 0)
+      ;
+    std::vector<pid_t> pids;
+    pids.reserve(_pids.size());
+    for (auto& p : _pids)
+      pids.push_back(p.first);
+    for (pid_t pid : pids)
+      _reap(pid);
+  } else {
+    auto it(_fds.find(&h));
+    if (it != _fds.end())
+      _reap(it->second);
+  }
+}
+
+/**
+ *  Stop watching a process, that will be waited by someone else.
+ *
+ *  @param[in] pid Process ID.
+ */
+void reaper::unwatch(pid_t pid) {
+  auto it(_pids.find(pid));
+  if (it == _pids.end())
+    return;
+  if (it->second) {
+    multiplexer::instance().reactor::remove(it->second.get());
+    _fds.erase(it->second.get());
+  }
+  _pids.erase(it);
+}
+
+/**
+ *  Watch a child process.
+ *
+ *  @param[in] pid Process ID.
+ */
+void reaper::watch(pid_t pid) {
+  if (_sigchld) {
+    _pids[pid];
+    return;
+  }
+
+  int fd(open_pidfd(pid));
+  if (fd < 0) {
+    char const* msg(strerror(errno));
+    throw basic_error() << "could not watch process " << pid << ": " << msg;
+  }
+  std::unique_ptr<pipe_handle> h(new pipe_handle(fd));
+  multiplexer::instance().reactor::add(h.get(), this);
+  _fds[h.get()] = pid;
+  _pids[pid] = std::move(h);
+}
+
+/**
+ *  Watched handles are always read.
+ *
+ *  @return true.
+ */
+bool reaper::want_read([[maybe_unused]] handle& h) {
+  return true;
+}
+
+/**************************************
+ *                                     *
+ *           Private Methods           *
+ *                                     *
+ **************************************/
+
+/**
+ *  Wait a process if it is over and report it.
+ *
+ *  @param[in] pid Process ID.
+ *
+ *  @return true if the process was over.
+ */
+bool reaper::_reap(pid_t pid) {
+  int status;
+  rusage usage;
+  pid_t ret;
+  do {
+    ret = wait4(pid, &status, WNOHANG, &usage);
+  } while (ret < 0 && errno == EINTR);
+  if (!ret)
+    return false;
+
+  unwatch(pid);
+  if (ret < 0) {
+    // Already waited by someone else.
+    if (errno != ECHILD) {
+      char const* msg(strerror(errno));
+      log::core()->error("could not wait process {0}: {1}", pid, msg);
+    }
+    return true;
+  }
+  log::core()->debug("process {0} used {1} ms of user and {2} ms of system "
+                     "CPU time", pid,
+                     usage.ru_utime.tv_sec * 1000 +
+                         usage.ru_utime.tv_usec / 1000,
+                     usage.ru_stime.tv_sec * 1000 +
+                         usage.ru_stime.tv_usec / 1000);
+  _callback(pid, status);
+  return true;
+}
@@ -19,6 +19,7 @@
 #include "com/centreon/connector/perl/reporter.hh"
 
 #include <sstream>
+#include <string>
 
 #include "com/centreon/connector/log.hh"
 #include "com/centreon/connector/perl/checks/result.hh"
@@ -77,36 +78,33 @@ void reporter::send_result(checks::result const& r) {
   log::core()->debug("reporting check result #{0} (check {1})", _reported,
                         r.get_command_id());
 
-  // Build packet.
-  std::ostringstream oss;
+  // Serialize packet directly into the write buffer.
+  std::string const& error(r.get_error());
+  std::string const& output(r.get_output());
+  _buffer.reserve(_buffer.size() + error.size() + output.size() + 64);
   // Packet ID.
-  oss << "3";
-  oss.put('\0');
+  _buffer.append("3", 2);
   // Command ID.
-  oss << r.get_command_id();
-  oss.put('\0');
+  _buffer.append(std::to_string(r.get_command_id()));
+  _buffer.push_back('\0');
   // Executed.
-  oss << (r.get_executed() ? "1" : "0");
-  oss.put('\0');
+  _buffer.append(r.get_executed() ? "1" : "0", 2);
   // Exit code.
-  oss << r.get_exit_code();
-  oss.put('\0');
+  _buffer.append(std::to_string(r.get_exit_code()));
+  _buffer.push_back('\0');
   // Error output.
-  if (r.get_error().empty())
-    oss.put(' ');
+  if (error.empty())
+    _buffer.push_back(' ');
   else
-    oss << r.get_error();
-  oss.put('\0');
+    _buffer.append(error);
+  _buffer.push_back('\0');
   // Standard output.
-  if (r.get_output().empty())
-    oss.put(' ');
+  if (output.empty())
+    _buffer.push_back(' ');
   else
-    oss << r.get_output();
+    _buffer.append(output);
   // Packet boundary.
-  for (unsigned int i = 0; i < 4; ++i)
-    oss.put('\0');
-  // Append packet to write buffer.
-  _buffer.append(oss.str());
+  _buffer.append(4, '\0');
 }
 
 /**
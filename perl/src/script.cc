@@ -24,13 +24,44 @@ char const* const com::centreon::connector::perl::embedded_perl::_script =
     "package Embed::Persistent;\n"
     "\n"
     "use Text::ParseWords qw(parse_line);\n"
+    "use Time::HiRes ();\n"
     "\n"
     "our %Cache;\n"
+    "our $InProcess = 0;\n"
     "\n"
     "use constant MTIME_IDX  => 0;\n"
     "use constant HANDLE_IDX => 1;\n"
+    "use constant EPN_IDX    => 2;\n"
     "\n"
-    "$| = 1;\n"
+    "# exit() must not end a worker running a plugin in-process.\n"
+    "BEGIN {\n"
+    "  *CORE::GLOBAL::exit = sub {\n"
+    "    my $code = @_ ? $_[0] : 0;\n"
+    "    die bless({ code => $code }, 'Embed::Persistent::Exit')\n"
+    "      if $InProcess;\n"
+    "    flush_outputs();\n"
+    "    CORE::exit($code);\n"
+    "  };\n"
+    "}\n"
+    "\n"
+    "# Outputs of plugins are buffered and written once they are over,\n"
+    "# even if killed by SIGTERM, unless plugins stream them.\n"
+    "sub buffer_outputs {\n"
+    "  local $!;\n"
+    "  binmode(STDERR, ':perlio');\n"
+    "  select((select(STDOUT), $| = 0)[0]);\n"
+    "  $SIG{TERM} = sub {\n"
+    "    flush_outputs();\n"
+    "    $SIG{TERM} = 'DEFAULT';\n"
+    "    kill('TERM', $$);\n"
+    "  };\n"
+    "}\n"
+    "\n"
+    "sub flush_outputs {\n"
+    "  local $!;\n"
+    "  select((select(STDOUT), $| = 1)[0]);\n"
+    "  select((select(STDERR), $| = 1)[0]);\n"
+    "}\n"
     "\n"
     "sub valid_package_name {\n"
     "  my ($string) = @_;\n"
@@ -85,16 +116,26 @@ char const* const com::centreon::connector::perl::embedded_perl::_script =
     "    die \"syntax error in '$filename': $@\";\n"
     "  }\n"
     "\n"
-    "  # Add script to cache.\n"
+    "  # Add script to cache. Plugins marked like ePN ones, with\n"
+    "  # '# nagios: +epn' in their first 10 lines, may run in-process.\n"
     "  $Cache{$filename}[MTIME_IDX] = $mtime;\n"
+    "  $Cache{$filename}[EPN_IDX] =\n"
+    "    grep({ /^\\s*#\\s*nagios:\\s*\\+epn/ } (split(/\\n/, $sub, 11))[0..9])\n"
+    "    ? 1 : 0;\n"
     "  no strict 'refs';\n"
     "  return $Cache{$filename}[HANDLE_IDX] = *{ $package . '::subroutine' "
     "}{CODE} ;\n"
     "}\n"
     "\n"
+    "sub expire_file {\n"
+    "  my ($filename) = @_;\n"
+    "  delete($Cache{$filename});\n"
+    "}\n"
+    "\n"
     "sub run_file {\n"
     "  # Fetch arguments.\n"
-    "  my ($filename, $handle, $args) = @_;\n"
+    "  my ($filename, $handle, $args, $autoflush) = @_;\n"
+    "  $autoflush ? flush_outputs() : buffer_outputs();\n"
     "\n"
     "  # Parse arguments.\n"
     "  my @parsed_args = (\"$filename\");\n"
@@ -103,9 +144,56 @@ char const* const com::centreon::connector::perl::embedded_perl::_script =
     "  # Run subroutine.\n"
     "  my $res;\n"
     "  eval { $res = $handle->(@parsed_args) };\n"
+    "  flush_outputs();\n"
     "  if ($@) {\n"
     "    chomp($@);\n"
     "    die \"could not run '$filename': $@\";\n"
     "  }\n"
     "  return ($res);\n"
+    "}\n"
+    "\n"
+    "sub in_process {\n"
+    "  my ($filename) = @_;\n"
+    "  return (exists($Cache{$filename}) && $Cache{$filename}[EPN_IDX]);\n"
+    "}\n"
+    "\n"
+    "sub run_file_in_process {\n"
+    "  # Fetch arguments.\n"
+    "  my ($filename, $handle, $args, $timeout) = @_;\n"
+    "\n"
+    "  # Parse arguments.\n"
+    "  my @parsed_args = (\"$filename\");\n"
+    "  push(@parsed_args, parse_line('\\s+', 0, $args));\n"
+    "\n"
+    "  # Run subroutine with outputs captured in memory, exit() caught\n"
+    "  # and a watchdog.\n"
+    "  my ($out, $err, $code) = ('', '', 3);\n"
+    "  {\n"
+    "    local *STDOUT;\n"
+    "    local *STDERR;\n"
+    "    open(STDOUT, '>', \\$out);\n"
+    "    open(STDERR, '>', \\$err);\n"
+    "    local $InProcess = 1;\n"
+    "    local $SIG{ALRM} = sub {\n"
+    "      die bless({ code => -1 }, 'Embed::Persistent::Exit');\n"
+    "    };\n"
+    "    Time::HiRes::alarm($timeout);\n"
+    "    eval { $handle->(@parsed_args) };\n"
+    "    Time::HiRes::alarm(0);\n"
+    "    # Mimic forked scripts ending without exit() or dying.\n"
+    "    if (ref($@) eq 'Embed::Persistent::Exit') {\n"
+    "      $code = $@->{code};\n"
+    "    }\n"
+    "    elsif ($@) {\n"
+    "      chomp($@);\n"
+    "      print STDERR \"could not run '$filename': $@\\n\";\n"
+    "      $code = 255;\n"
+    "    }\n"
+    "    else {\n"
+    "      print STDERR \"error while executing Perl script '$filename': \\n\";\n"
+    "    }\n"
+    "    close(STDOUT);\n"
+    "    close(STDERR);\n"
+    "  }\n"
+    "  return ($code, $out, $err);\n"
     "}\n\n";
@@ -0,0 +1,819 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#include "com/centreon/connector/perl/worker_pool.hh"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+
+#include "com/centreon/connector/log.hh"
+#include "com/centreon/connector/perl/checks/check.hh"
+#include "com/centreon/connector/perl/embedded_perl.hh"
+#include "com/centreon/connector/perl/multiplexer.hh"
+#include "com/centreon/connector/perl/reaper.hh"
+#include "com/centreon/exceptions/basic.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::connector;
+using namespace com::centreon::connector::perl;
+
+/**************************************
+ *                                     *
+ *           Local Objects             *
+ *                                     *
+ **************************************/
+
+namespace {
+// Messages exchanged between the connector and its workers.
+enum message_type : uint32_t {
+  msg_execute = 1,  // Connector -> worker, payload is the deadline in
+                    // milliseconds and the command line.
+  msg_started,      // Worker -> connector, value is the PID, with FDs.
+  msg_exited,       // Worker -> connector, value is the wait status.
+  msg_failed,       // Worker -> connector, payload is the error.
+  msg_running,      // Worker -> connector, value is the worker PID.
+  msg_done          // Worker -> connector, value is the exit code,
+                    // payload is the output size, the truncated
+                    // outputs (bit 0 stdout, bit 1 stderr) and both
+                    // outputs.
+};
+
+struct message {
+  uint32_t type;
+  int32_t value;
+  uint64_t cmd_id;
+};
+}  // namespace
+
+// Socket of a worker process, closed in the checks it forks.
+static int gl_worker_sock = -1;
+
+/**
+ *  Close the worker socket in a forked check, so that the connector
+ *  notices at once when the worker is gone.
+ */
+static void close_worker_sock() {
+  if (gl_worker_sock >= 0) {
+    ::close(gl_worker_sock);
+    gl_worker_sock = -1;
+  }
+}
+
+// Maximum size of a message, command lines are much shorter.
+static size_t const max_message_size = 65536;
+
+/**
+ *  Send a message on a worker socket.
+ *
+ *  @param[in] sock      Socket.
+ *  @param[in] m         Message header.
+ *  @param[in] payload   Message payload.
+ *  @param[in] fds       Descriptors to pass along, if any.
+ *  @param[in] fds_count Number of descriptors.
+ */
+static void send_message(int sock,
+                         message const& m,
+                         std::string const& payload = std::string(),
+                         int const* fds = nullptr,
+                         int fds_count = 0) {
+  iovec iov[2];
+  iov[0].iov_base = const_cast<message*>(&m);
+  iov[0].iov_len = sizeof(m);
+  iov[1].iov_base = const_cast<char*>(payload.data());
+  iov[1].iov_len = payload.size();
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = payload.empty() ? 1 : 2;
+  char control[CMSG_SPACE(2 * sizeof(int))];
+  if (fds_count) {
+    memset(control, 0, sizeof(control));
+    msg.msg_control = control;
+    msg.msg_controllen = CMSG_SPACE(fds_count * sizeof(int));
+    cmsghdr* cmsg(CMSG_FIRSTHDR(&msg));
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(fds_count * sizeof(int));
+    memcpy(CMSG_DATA(cmsg), fds, fds_count * sizeof(int));
+  }
+  ssize_t wb;
+  do {
+    wb = sendmsg(sock, &msg, MSG_NOSIGNAL);
+  } while (wb < 0 && errno == EINTR);
+  if (wb < 0) {
+    char const* msg(strerror(errno));
+    throw basic_error() << "could not send message to worker: " << msg;
+  }
+}
+
+/**
+ *  Send a message prepared with its payload on a worker socket,
+ *  without blocking.
+ *
+ *  @param[in] sock   Socket.
+ *  @param[in] packet Message header followed by its payload.
+ *
+ *  @return false if the socket is full and the message was not sent.
+ */
+static bool send_packet(int sock, std::string const& packet) {
+  ssize_t wb;
+  do {
+    wb = send(sock, packet.data(), packet.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+  } while (wb < 0 && errno == EINTR);
+  if (wb < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+      return false;
+    char const* msg(strerror(errno));
+    throw basic_error() << "could not send message to worker: " << msg;
+  }
+  return true;
+}
+
+/**
+ *  Receive a message from a worker socket.
+ *
+ *  @param[in]  sock      Socket.
+ *  @param[out] m         Message header.
+ *  @param[out] payload   Message payload.
+ *  @param[out] fds       Descriptors received (two at most).
+ *  @param[out] fds_count Number of descriptors received.
+ *  @param[in]  flags     recvmsg() flags.
+ *
+ *  @return 1 if a message was received, 0 if the peer closed the
+ *          socket, -1 if no message is available yet.
+ */
+static int receive_message(int sock,
+                           message& m,
+                           std::string& payload,
+                           int fds[2],
+                           int& fds_count,
+                           int flags = 0) {
+  char buffer[max_message_size];
+  iovec iov;
+  iov.iov_base = buffer;
+  iov.iov_len = sizeof(buffer);
+  char control[CMSG_SPACE(2 * sizeof(int))];
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  ssize_t rb;
+  do {
+    rb = recvmsg(sock, &msg, flags | MSG_CMSG_CLOEXEC);
+  } while (rb < 0 && errno == EINTR);
+  if (rb < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+      return -1;
+    char const* msg(strerror(errno));
+    throw basic_error() << "could not receive message from worker: " << msg;
+  }
+
+  // Collect passed descriptors.
+  fds_count = 0;
+  for (cmsghdr* cmsg(CMSG_FIRSTHDR(&msg)); cmsg;
+       cmsg = CMSG_NXTHDR(&msg, cmsg))
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+      size_t count((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+      for (size_t i = 0; i < count; ++i) {
+        int fd;
+        memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(fd));
+        if (fds_count < 2)
+          fds[fds_count++] = fd;
+        else
+          ::close(fd);
+      }
+    }
+
+  if (!rb)
+    return 0;
+  if (static_cast<size_t>(rb) < sizeof(m) ||
+      (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC))) {
+    while (fds_count)
+      ::close(fds[--fds_count]);
+    throw basic_error() << "invalid message received from worker";
+  }
+  memcpy(&m, buffer, sizeof(m));
+  payload.assign(buffer + sizeof(m), rb - sizeof(m));
+  return 1;
+}
+
+/**************************************
+ *                                     *
+ *           Public Methods            *
+ *                                     *
+ **************************************/
+
+/**
+ *  Constructor. Worker processes are started immediately.
+ *
+ *  @param[in] processes  Reaper waiting for worker processes.
+ *  @param[in] size       Number of worker processes.
+ *  @param[in] max_checks Number of checks after which a worker is
+ *                        replaced, 0 for no limit.
+ *  @param[in] zygote     Workers load Perl themselves, the connector
+ *                        did not.
+ *  @param[in] code       Additional code run by the interpreters of
+ *                        workers in zygote mode.
+ *  @param[in] in_process Run scripts marked with '# nagios: +epn'
+ *                        within workers, without forking.
+ *  @param[in] memfd      Checks write their outputs to memory files.
+ */
+worker_pool::worker_pool(reaper& processes,
+                         unsigned int size,
+                         unsigned int max_checks,
+                         bool zygote,
+                         std::string const& code,
+                         bool in_process,
+                         bool memfd)
+    : _code(code),
+      _in_process(in_process),
+      _max_checks(max_checks),
+      _memfd(memfd),
+      _reaper(processes),
+      _size(size),
+      _zygote(zygote) {
+  log::core()->info(
+      "starting {0} worker processes (replaced after {1} checks, 0 means "
+      "never){2}{3}",
+      _size, _max_checks, (_zygote ? " loading Perl themselves" : ""),
+      (_in_process ? " running marked scripts in-process" : ""));
+  for (unsigned int i = 0; i < _size; ++i)
+    _spawn();
+}
+
+/**
+ *  Destructor. Running checks are dropped and workers are stopped.
+ */
+worker_pool::~worker_pool() noexcept {
+  for (auto& p : _checks) {
+    try {
+      p.second.first->unlisten(nullptr);
+    } catch (...) {
+    }
+    delete p.second.first;
+  }
+  _checks.clear();
+
+  for (auto& w : _workers) {
+    try {
+      multiplexer::instance().reactor::remove(&w->sock);
+    } catch (...) {
+    }
+    w->sock.close();
+    _reaper.unwatch(w->pid);
+    kill(w->pid, SIGTERM);
+    waitpid(w->pid, nullptr, 0);
+  }
+  _workers.clear();
+}
+
+/**
+ *  Error occurred on a worker socket.
+ *
+ *  @param[in] h Worker socket.
+ */
+void worker_pool::error(handle& h) {
+  for (auto& w : _workers)
+    if (&w->sock == &h) {
+      log::core()->error("error on socket of worker process {}", w->pid);
+      _close(w.get());
+      break;
+    }
+}
+
+/**
+ *  Execute a check in the least busy worker.
+ *
+ *  @param[in] cmd_id Command ID.
+ *  @param[in] cmd    Command line.
+ *  @param[in] tmt    Timeout.
+ *  @param[in] chk    Check, owned by the pool from now on.
+ */
+void worker_pool::execute(uint64_t cmd_id,
+                          std::string const& cmd,
+                          const timestamp& tmt,
+                          std::unique_ptr<checks::check>&& chk) {
+  // Replace workers that died.
+  while (_workers.size() < _size)
+    _spawn();
+
+  // Blocked workers are only picked when all workers are.
+  worker* w(nullptr);
+  for (auto& wk : _workers)
+    if (!wk->retiring &&
+        (!w || (w->blocked && !wk->blocked) ||
+         (w->blocked == wk->blocked && wk->running < w->running)))
+      w = wk.get();
+  if (!w)
+    throw basic_error() << "no worker process available";
+  uint64_t deadline(tmt.to_mseconds());
+  if (sizeof(message) + sizeof(deadline) + cmd.size() > max_message_size)
+    throw basic_error() << "command line of check " << cmd_id
+                        << " is too long";
+
+  // The deadline is absolute, the order might wait in the worker.
+  message m;
+  m.type = msg_execute;
+  m.value = 0;
+  m.cmd_id = cmd_id;
+  std::string packet(reinterpret_cast<char const*>(&m), sizeof(m));
+  packet.append(reinterpret_cast<char const*>(&deadline), sizeof(deadline));
+  packet.append(cmd);
+  if (w->orders.empty() &&
+      send_packet(w->sock.get_native_handle(), packet))
+    log::core()->debug("check {0} sent to worker process {1}", cmd_id,
+                       w->pid);
+  else {
+    log::core()->debug("check {0} queued for worker process {1}", cmd_id,
+                       w->pid);
+    w->orders.push_back(std::move(packet));
+    multiplexer::instance().reactor::update(&w->sock);
+  }
+
+  chk->prepare(cmd_id, tmt);
+  _checks[cmd_id] = std::make_pair(chk.release(), w);
+  ++w->running;
+  if (_max_checks && ++w->checks_count >= _max_checks)
+    _retire(w);
+}
+
+/**
+ *  Get the number of checks running in workers.
+ *
+ *  @return Number of checks.
+ */
+size_t worker_pool::get_checks_count() const noexcept {
+  return _checks.size();
+}
+
+/**
+ *  Read messages sent by a worker.
+ *
+ *  @param[in] h Worker socket.
+ */
+void worker_pool::read(handle& h) {
+  worker* w(_find(h));
+  if (!w)
+    return;
+
+  for (;;) {
+    message m;
+    std::string payload;
+    int fds[2];
+    int fds_count(0);
+    int ret;
+    try {
+      ret = receive_message(w->sock.get_native_handle(), m, payload, fds,
+                            fds_count, MSG_DONTWAIT);
+    } catch (std::exception const& e) {
+      log::core()->error("worker process {0}: {1}", w->pid, e.what());
+      ret = 0;
+    }
+    if (ret < 0)
+      return;
+    if (!ret) {
+      while (fds_count)
+        ::close(fds[--fds_count]);
+      _close(w);
+      return;
+    }
+
+    auto it(_checks.find(m.cmd_id));
+    if (it == _checks.end()) {
+      while (fds_count)
+        ::close(fds[--fds_count]);
+      continue;
+    }
+    checks::check* chk(it->second.first);
+    switch (m.type) {
+      case msg_started:
+        if (fds_count == 2) {
+          chk->start(m.value, fds[0], fds[1]);
+          continue;
+        }
+        while (fds_count)
+          ::close(fds[--fds_count]);
+        log::core()->error(
+            "worker process {0} did not send outputs of check {1}", w->pid,
+            m.cmd_id);
+        chk->fail();
+        break;
+      case msg_exited:
+        log::core()->info("check {0} exited with status {1}", m.cmd_id,
+                          m.value);
+        if (WIFSIGNALED(m.value))
+          log::core()->error("check {0} exited because of a signal {1}",
+                             m.cmd_id, WTERMSIG(m.value));
+        chk->terminated(WIFEXITED(m.value) ? WEXITSTATUS(m.value) : -1);
+        break;
+      case msg_running:
+        w->blocked = true;
+        chk->start_in_process(m.value);
+        continue;
+      case msg_done: {
+        w->blocked = false;
+        uint32_t header[2] = {0, 0};
+        if (payload.size() >= sizeof(header))
+          memcpy(header, payload.data(), sizeof(header));
+        if (payload.size() < sizeof(header) ||
+            header[0] > payload.size() - sizeof(header)) {
+          log::core()->error("invalid result of check {0} from worker {1}",
+                             m.cmd_id, w->pid);
+          chk->fail();
+          break;
+        }
+        log::core()->info("check {0} ran in-process with exit code {1}",
+                          m.cmd_id, m.value);
+        chk->complete(m.value, payload.substr(sizeof(header), header[0]),
+                      payload.substr(sizeof(header) + header[0]),
+                      header[1] & 1, header[1] & 2);
+      } break;
+      case msg_failed:
+        log::core()->info("execution of check {0} failed {1}", m.cmd_id,
+                          payload);
+        chk->fail();
+        break;
+      default:
+        continue;
+    }
+
+    // Check is over.
+    _checks.erase(it);
+    delete chk;
+    --w->running;
+  }
+}
+
+/**
+ *  Worker sockets are always read.
+ *
+ *  @return true.
+ */
+bool worker_pool::want_read([[maybe_unused]] handle& h) {
+  return true;
+}
+
+/**
+ *  Worker sockets are written while orders are queued.
+ *
+ *  @param[in] h Worker socket.
+ *
+ *  @return true if orders wait for the socket.
+ */
+bool worker_pool::want_write(handle& h) {
+  worker* w(_find(h));
+  return w && !w->orders.empty();
+}
+
+/**
+ *  Send queued orders to a worker, as long as its socket accepts them.
+ *
+ *  @param[in] h Worker socket.
+ */
+void worker_pool::write(handle& h) {
+  worker* w(_find(h));
+  if (!w)
+    return;
+  try {
+    while (!w->orders.empty() &&
+           send_packet(w->sock.get_native_handle(), w->orders.front()))
+      w->orders.pop_front();
+  } catch (std::exception const& e) {
+    log::core()->error("worker process {0}: {1}", w->pid, e.what());
+    _close(w);
+    return;
+  }
+  if (w->orders.empty()) {
+    // A retiring worker exits once it got all its orders.
+    if (w->retiring)
+      shutdown(w->sock.get_native_handle(), SHUT_WR);
+    multiplexer::instance().reactor::update(&w->sock);
+  }
+}
+
+/**************************************
+ *                                     *
+ *           Private Methods           *
+ *                                     *
+ **************************************/
+
+/**
+ *  Forget a worker whose socket was closed. Its remaining checks fail.
+ *
+ *  @param[in] w Worker.
+ */
+void worker_pool::_close(worker* w) {
+  if (!w->retiring || w->running)
+    log::core()->error("worker process {0} exited with {1} running checks",
+                       w->pid, w->running);
+  else
+    log::core()->info("worker process {} exited", w->pid);
+  multiplexer::instance().reactor::remove(&w->sock);
+
+  for (auto it(_checks.begin()); it != _checks.end();) {
+    if (it->second.second == w) {
+      std::unique_ptr<checks::check> chk(it->second.first);
+      it = _checks.erase(it);
+      chk->fail();
+    } else
+      ++it;
+  }
+
+  for (auto it(_workers.begin()); it != _workers.end(); ++it)
+    if (it->get() == w) {
+      _workers.erase(it);
+      break;
+    }
+}
+
+/**
+ *  Find the worker of a socket.
+ *
+ *  @param[in] h Worker socket.
+ *
+ *  @return Worker, nullptr if none.
+ */
+worker_pool::worker* worker_pool::_find(handle& h) const noexcept {
+  for (auto& w : _workers)
+    if (&w->sock == &h)
+      return w.get();
+  return nullptr;
+}
+
+/**
+ *  Stop sending checks to a worker and start its replacement. The
+ *  worker exits once its running checks are over.
+ *
+ *  @param[in] w Worker.
+ */
+void worker_pool::_retire(worker* w) {
+  log::core()->info("worker process {0} ran {1} checks, replacing it", w->pid,
+                    w->checks_count);
+  w->retiring = true;
+  if (w->orders.empty())
+    shutdown(w->sock.get_native_handle(), SHUT_WR);
+  try {
+    _spawn();
+  } catch (std::exception const& e) {
+    log::core()->error("could not start worker process: {}", e.what());
+  }
+}
+
+/**
+ *  Run a check within the worker process and send its result.
+ *
+ *  @param[in] sock     Socket connected to the connector.
+ *  @param[in] cmd_id   Command ID.
+ *  @param[in] cmd      Command line.
+ *  @param[in] deadline Deadline in milliseconds.
+ */
+void worker_pool::_run_in_process(int sock,
+                                  uint64_t cmd_id,
+                                  std::string const& cmd,
+                                  uint64_t deadline) {
+  message m;
+  m.type = msg_running;
+  m.value = getpid();
+  m.cmd_id = cmd_id;
+  send_message(sock, m);
+
+  // The watchdog fires at the deadline, before the connector kills the
+  // worker. A check that waited past its deadline is not run at all.
+  std::string out;
+  std::string err;
+  int exit_code(-1);
+  uint64_t now(timestamp::now().to_mseconds());
+  if (deadline > now)
+    exit_code = embedded_perl::instance().run_in_process(cmd, deadline - now,
+                                                         out, err);
+
+  // Outputs are cut to fit in a single message, the connector reports
+  // them as truncated.
+  uint32_t header[2];
+  size_t room(max_message_size - sizeof(m) - sizeof(header));
+  header[1] = 0;
+  if (out.size() > room) {
+    out.resize(room);
+    header[1] |= 1;
+  }
+  if (err.size() > room - out.size()) {
+    err.resize(room - out.size());
+    header[1] |= 2;
+  }
+  header[0] = out.size();
+  std::string payload(reinterpret_cast<char const*>(header), sizeof(header));
+  payload.append(out);
+  payload.append(err);
+
+  m.type = msg_done;
+  m.value = exit_code < 0 ? -1 : (exit_code & 0xff);
+  send_message(sock, m, payload);
+}
+
+/**
+ *  Start a new worker process.
+ */
+void worker_pool::_spawn() {
+  int sv[2];
+  if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv)) {
+    char const* msg(strerror(errno));
+    throw basic_error() << "could not create worker socket: " << msg;
+  }
+  pid_t pid(fork());
+  if (pid < 0) {
+    char const* msg(strerror(errno));
+    ::close(sv[0]);
+    ::close(sv[1]);
+    throw basic_error() << "could not start worker process: " << msg;
+  } else if (!pid) {
+    ::close(sv[0]);
+    _work(sv[1]);
+  }
+  ::close(sv[1]);
+
+  std::unique_ptr<worker> w(new worker);
+  w->blocked = false;
+  w->checks_count = 0;
+  w->pid = pid;
+  w->retiring = false;
+  w->running = 0;
+  w->sock.set_fd(sv[0]);
+  _reaper.watch(pid);
+  multiplexer::instance().reactor::add(&w->sock, this);
+  log::core()->info("worker process {} started", pid);
+  _workers.push_back(std::move(w));
+}
+
+/**
+ *  Main loop of worker processes. Checks are forked as they are
+ *  received and their termination is reported, until the connector
+ *  closes the socket and all checks are over.
+ *
+ *  @param[in] sock Socket connected to the connector.
+ */
+void worker_pool::_work(int sock) {
+  try {
+    // Sockets of the other workers would keep them alive after the
+    // connector, other descriptors of the connector are close-on-exec.
+    // The standard output of the connector carries results, nothing
+    // run by a worker (e.g. system() in an in-process script) must
+    // write to it, nor to the standard error unless logs go there.
+    for (auto& w : _workers)
+      w->sock.close();
+    int null_fd(open("/dev/null", O_RDWR | O_CLOEXEC));
+    if (null_fd >= 0) {
+      dup2(null_fd, STDIN_FILENO);
+      dup2(null_fd, STDOUT_FILENO);
+      if (!log::instance().is_on_stderr())
+        dup2(null_fd, STDERR_FILENO);
+      ::close(null_fd);
+    }
+    signal(SIGTERM, SIG_DFL);
+
+    // In zygote mode, the interpreter and its compiled plugins only
+    // live in workers.
+    if (_zygote) {
+      embedded_perl::load(nullptr, nullptr, nullptr,
+                          (_code.empty() ? nullptr : _code.c_str()));
+      embedded_perl::instance().warm_up();
+    } else
+      embedded_perl::instance().renew_watcher();
+    int watcher(embedded_perl::instance().get_watcher().get_native_handle());
+
+    // Children termination is read from a signalfd.
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &mask, nullptr);
+    pipe_handle sig(signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC));
+    if (sig.get_native_handle() < 0) {
+      char const* msg(strerror(errno));
+      throw basic_error() << "could not create signalfd: " << msg;
+    }
+    pipe_handle channel(sock);
+    gl_worker_sock = sock;
+    pthread_atfork(nullptr, nullptr, &close_worker_sock);
+
+    umap<pid_t, uint64_t> running;
+    bool accepting(true);
+    while (accepting || !running.empty()) {
+      pollfd fds[3];
+      fds[0].fd = accepting ? sock : -1;
+      fds[0].events = POLLIN;
+      fds[0].revents = 0;
+      fds[1].fd = sig.get_native_handle();
+      fds[1].events = POLLIN;
+      fds[1].revents = 0;
+      fds[2].fd = watcher;
+      fds[2].events = POLLIN;
+      fds[2].revents = 0;
+      if (poll(fds, 3, -1) < 0) {
+        if (errno == EINTR)
+          continue;
+        char const* msg(strerror(errno));
+        throw basic_error() << "poll failed: " << msg;
+      }
+
+      // Changed scripts will be compiled again.
+      if (fds[2].revents)
+        embedded_perl::instance().expire_changed();
+
+      // Report terminated checks.
+      if (fds[1].revents) {
+        signalfd_siginfo si;
+        while (::read(fds[1].fd, &si, sizeof(si)) > 0)
+          ;
+        int status;
+        pid_t child;
+        while ((child = waitpid(-1, &status, WNOHANG)) > 0) {
+          auto it(running.find(child));
+          if (it != running.end()) {
+            message m;
+            m.type = msg_exited;
+            m.value = status;
+            m.cmd_id = it->second;
+            running.erase(it);
+            send_message(sock, m);
+          }
+        }
+      }
+
+      // Start new checks.
+      if (fds[0].revents) {
+        message m;
+        std::string cmd;
+        int passed[2];
+        int passed_count(0);
+        int ret(receive_message(sock, m, cmd, passed, passed_count));
+        while (passed_count)
+          ::close(passed[--passed_count]);
+        if (!ret) {
+          accepting = false;
+          continue;
+        }
+        uint64_t deadline;
+        if (m.type != msg_execute || cmd.size() < sizeof(deadline))
+          continue;
+        memcpy(&deadline, cmd.data(), sizeof(deadline));
+        cmd.erase(0, sizeof(deadline));
+        message reply;
+        reply.cmd_id = m.cmd_id;
+        try {
+          if (_in_process && embedded_perl::instance().is_in_process(cmd)) {
+            _run_in_process(sock, m.cmd_id, cmd, deadline);
+            continue;
+          }
+          int out[2];
+          pid_t child(embedded_perl::instance().run(cmd, out, _memfd));
+          running[child] = m.cmd_id;
+          reply.type = msg_started;
+          reply.value = child;
+          try {
+            send_message(sock, reply, std::string(), out, 2);
+          } catch (...) {
+            ::close(out[0]);
+            ::close(out[1]);
+            throw;
+          }
+          ::close(out[0]);
+          ::close(out[1]);
+        } catch (exceptions::basic const& e) {
+          reply.type = msg_failed;
+          reply.value = 0;
+          send_message(sock, reply, e.what());
+        }
+      }
+    }
+  } catch (std::exception const& e) {
+    log::core()->error("worker process {0} failed: {1}", getpid(), e.what());
+    _exit(EXIT_FAILURE);
+  }
+  _exit(EXIT_SUCCESS);
+}
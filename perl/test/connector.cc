@@ -18,7 +18,9 @@
  */
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <fstream>
+#include <thread>
 
 #include "com/centreon/clib.hh"
 #include "com/centreon/exceptions/basic.hh"
@@ -69,6 +71,14 @@ static constexpr const char scripts[] =
   " \0"                   \
   " \0\0\0\0"
 
+#define OutputTruncatedRESULT \
+  "3\0"                       \
+  "4242\0"                    \
+  "1\0"                       \
+  "3\0"                       \
+  " \0"                       \
+  "xxxxxxxxxxxxxxxx\n(output truncated)\0\0\0\0"
+
 #define TimeoutKillCMD \
   "2\0"                \
   "4242\0"             \
@@ -171,6 +181,140 @@ TEST_F(TestConnector, EofOnStdin) {
   ASSERT_EQ(retval, 0);
 }
 
+TEST_F(TestConnector, ExecuteBrokenScript) {
+  // Write broken Perl script.
+  std::string script_path(io::file_stream::temp_path());
+  _write_file(script_path.c_str(),
+              "#!/usr/bin/perl\n"
+              "\n"
+              "print \"Centreon is broken\\n\"\n"
+              "exit 0;\n");
+  std::string log_path(io::file_stream::temp_path());
+
+  // Process.
+  p.exec(perl_connector + " --debug --log-file " + log_path);
+
+  // Run the script twice, and wait for both results.
+  auto order = [&script_path](unsigned int id) {
+    std::ostringstream oss;
+    oss.write(cmd3, sizeof(cmd3) - 1);
+    oss << id;
+    oss.write(cmd4, sizeof(cmd4) - 1);
+    oss << script_path;
+    oss.write(cmd5, sizeof(cmd5) - 1);
+    return oss.str();
+  };
+  std::string cmd(order(1) + order(2));
+  for (unsigned int size(0); size < cmd.size();)
+    size += p.write(cmd.c_str() + size, cmd.size() - size);
+  std::string output;
+  std::string const boundary(cmd5, sizeof(cmd5) - 1);
+  auto results = [&output, &boundary]() {
+    unsigned int retval(0);
+    for (size_t pos(0); (pos = output.find(boundary, pos)) != std::string::npos;
+         ++retval, pos += boundary.size())
+      ;
+    return retval;
+  };
+  while (results() < 2) {
+    std::string buffer;
+    p.read(buffer);
+    if (buffer.empty())
+      break;
+    output.append(buffer);
+  }
+
+  // Fix the script and run it again.
+  _write_file(script_path.c_str(), scripts, sizeof(scripts) - 1);
+  write_cmd(order(3));
+
+  // Read reply.
+  output.append(read_reply());
+
+  int retval{wait_for_termination()};
+
+  // The broken script was compiled once, the fixed one once.
+  std::ifstream log_file(log_path);
+  std::string log((std::istreambuf_iterator<char>(log_file)),
+                  std::istreambuf_iterator<char>());
+  unsigned int compilations(0);
+  std::string parsing("parsing file " + script_path);
+  for (size_t pos(0); (pos = log.find(parsing, pos)) != std::string::npos;
+       ++compilations, ++pos)
+    ;
+
+  // Remove temporary files.
+  remove(script_path.c_str());
+  remove(log_path.c_str());
+
+  ASSERT_EQ(retval, 0);
+  ASSERT_NE(output.find(std::string("3\0" "1\0" "0\0", 7)),
+            std::string::npos);
+  ASSERT_NE(output.find(std::string("3\0" "2\0" "0\0", 7)),
+            std::string::npos);
+  ASSERT_NE(output.find(std::string("3\0" "3\0" "1\0" "2\0", 9)),
+            std::string::npos);
+  ASSERT_NE(output.find(result2), std::string::npos);
+  ASSERT_EQ(compilations, 2u);
+}
+
+TEST_F(TestConnector, ExecuteChangedScript) {
+  // Write Perl script.
+  std::string script_path(io::file_stream::temp_path());
+  _write_file(script_path.c_str(), scripts, sizeof(scripts) - 1);
+
+  // Process.
+  p.exec(perl_connector);
+
+  // Run the script once, and wait for its result.
+  std::ostringstream oss;
+  oss.write(cmd3, sizeof(cmd3) - 1);
+  oss << 1;
+  oss.write(cmd4, sizeof(cmd4) - 1);
+  oss << script_path;
+  oss.write(cmd5, sizeof(cmd5) - 1);
+  std::string cmd(oss.str());
+  for (unsigned int size(0); size < cmd.size();)
+    size += p.write(cmd.c_str() + size, cmd.size() - size);
+  std::string output;
+  while (output.find(result2) == std::string::npos) {
+    std::string buffer;
+    p.read(buffer);
+    if (buffer.empty())
+      break;
+    output.append(buffer);
+  }
+
+  // Rewrite the script and let the connector notice it.
+  _write_file(script_path.c_str(),
+              "#!/usr/bin/perl\n"
+              "\n"
+              "print \"Centreon is changed\\n\";\n"
+              "exit 2;\n");
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  // Run it again.
+  oss.str("");
+  oss.write(cmd3, sizeof(cmd3) - 1);
+  oss << 2;
+  oss.write(cmd4, sizeof(cmd4) - 1);
+  oss << script_path;
+  oss.write(cmd5, sizeof(cmd5) - 1);
+  write_cmd(oss.str());
+
+  // Read reply.
+  output.append(read_reply());
+
+  int retval{wait_for_termination()};
+
+  // Remove temporary files.
+  remove(script_path.c_str());
+
+  ASSERT_EQ(retval, 0);
+  ASSERT_NE(output.find(result2), std::string::npos);
+  ASSERT_NE(output.find("Centreon is changed\n"), std::string::npos);
+}
+
 TEST_F(TestConnector, ExecuteModuleLoading) {
   // Write Perl script.
   std::string script_path(io::file_stream::temp_path());
@@ -250,6 +394,50 @@ TEST_F(TestConnector, ExecuteMultipleScripts) {
   ASSERT_EQ(retval, 0);
 }
 
+TEST_F(TestConnector, ExecuteMultipleScriptsWorkers) {
+  // Write Perl scripts.
+  std::string script_paths[10];
+  for (auto & script_path : script_paths) {
+    script_path = io::file_stream::temp_path();
+    _write_file(script_path.c_str(), scripts, sizeof(scripts) - 1);
+  }
+
+  // Process.
+  p.exec(perl_connector + " --workers 4 --max-checks-per-worker 50");
+
+  // Generate command string.
+  std::string cmd;
+  {
+    std::ostringstream oss;
+    for (unsigned int i = 0; i < count; ++i) {
+      oss.write(cmd3, sizeof(cmd3) - 1);
+      oss << i + 1;
+      oss.write(cmd4, sizeof(cmd4) - 1);
+      oss << script_paths[i % (sizeof(script_paths) / sizeof(*script_paths))];
+      oss.write(cmd5, sizeof(cmd5) - 1);
+    }
+    cmd = oss.str();
+  }
+  write_cmd(cmd);
+
+  // Read reply.
+  std::string output{std::move(read_reply())};
+
+  int retval{wait_for_termination()};
+
+  // Remove temporary files.
+  for (auto & script_path : script_paths)
+    remove(script_path.c_str());
+
+  unsigned int nb_right_output(0);
+  for (size_t pos(0); (pos = output.find(result2, pos)) != std::string::npos;
+       ++nb_right_output, ++pos)
+    ;
+
+  ASSERT_TRUE(nb_right_output == count);
+  ASSERT_EQ(retval, 0);
+}
+
 TEST_F(TestConnector, ExecuteSingleScript) {
   // Write Perl script.
   std::string script_path(io::file_stream::temp_path());
@@ -367,6 +555,442 @@ TEST_F(TestConnector, ExecuteWithAdditionalCode) {
   ASSERT_FALSE(memcmp(output.c_str(), result, sizeof(result) - 1));
 }
 
+TEST_F(TestConnector, ExecuteZygote) {
+  // Write Perl script.
+  std::string script_path(io::file_stream::temp_path());
+  _write_file(
+      script_path.c_str(),
+      "#!/usr/bin/perl\n"
+      "\n"
+      "print \"$Centreon::Test::company is $Centreon::Test::attribute\\n\";\n"
+      "exit 0;\n");
+
+  // Process.
+  p.exec(
+      perl_connector +
+      " --zygote --code 'package Centreon::Test; our $company=\"Centreon\"; "
+      "our $attribute=\"wonderful\";'");
+
+  // Write command.
+  std::ostringstream oss;
+  oss.write(cmd1, sizeof(cmd1) - 1);
+  oss << script_path;
+  oss.write(cmd2, sizeof(cmd2) - 1);
+  write_cmd(oss.str());
+
+  // Read reply.
+  std::string output{std::move(read_reply())};
+
+  int retval{wait_for_termination()};
+
+  // Remove temporary files.
+  remove(script_path.c_str());
+
+  ASSERT_EQ(retval, 0);
+  ASSERT_EQ(output.size(), (sizeof(result) - 1));
+  ASSERT_FALSE(memcmp(output.c_str(), result, sizeof(result) - 1));
+}
+
+TEST_F(TestConnector, ExecuteInProcess) {
+  // Write Perl script.
+  std::string script_path(io::file_stream::temp_path());
+  _write_file(
+      script_path.c_str(),
+      "#!/usr/bin/perl\n"
+      "# nagios: +epn\n"
+      "\n"
+      "print \"$Centreon::Test::company is $Centreon::Test::attribute\\n\";\n"
+      "exit 0;\n");
+
+  // Process.
+  p.exec(
+      perl_connector +
+      " --in-process --code 'package Centreon::Test; "
+      "our $company=\"Centreon\"; our $attribute=\"wonderful\";'");
+
+  // Write command.
+  std::ostringstream oss;
+  oss.write(cmd1, sizeof(cmd1) - 1);
+  oss << script_path;
+  oss.write(cmd2, sizeof(cmd2) - 1);
+  write_cmd(oss.str());
+
+  // Read reply.
+  std::string output{std::move(read_reply())};
+
+  int retval{wait_for_termination()};
+
+  // Remove temporary files.
+  remove(script_path.c_str());
+
+  ASSERT_EQ(retval, 0);
+  ASSERT_EQ(output.size(), (sizeof(result) - 1));
+  ASSERT_FALSE(memcmp(output.c_str(), result, sizeof(result) - 1));
+}
+
+TEST_F(TestConnector, ExecuteInProcessSystem) {
+  // Write Perl script, its commands must not write to the connector
+  // output.
+  std::string script_path(io::file_stream::temp_path());
+  _write_file(script_path.c_str(),
+              "#!/usr/bin/perl\n"
+              "# nagios: +epn\n"
+              "\n"
+              "system(\"echo injected\");\n"
+              "print \"Centreon is wonderful\\n\";\n"
+              "exit 0;\n");
+
+  // Process.
+  p.exec(perl_connector + " --in-process");
+
+  // Write command.
+  std::ostringstream oss;
+  oss.write(cmd1, sizeof(cmd1) - 1);
+  oss << script_path;
+  oss.write(cmd2, sizeof(cmd2) - 1);
+  write_cmd(oss.str());
+
+  // Read reply.
+  std::string output{std::move(read_reply())};
+
+  int retval{wait_for_termination()};
+
+  // Remove temporary files.
+  remove(script_path.c_str());
+
+  ASSERT_EQ(retval, 0);
+  ASSERT_EQ(output.size(), (sizeof(result) - 1));
+  ASSERT_FALSE(memcmp(output.c_str(), result, sizeof(result) - 1));
+}
+
+TEST_F(TestConnector, ExecuteInProcessTimeoutBeforeStart) {
+  // Write Perl scripts, the first one keeps the only worker busy.
+  std::string busy_path(io::file_stream::temp_path());
+  _write_file(busy_path.c_str(),
+              "#!/usr/bin/perl\n"
+              "# nagios: +epn\n"
+              "\n"
+              "sleep 2;\n"
+              "print \"Centreon is wonderful\\n\";\n"
+              "exit 0;\n");
+  std::string script_path(io::file_stream::temp_path());
+  _write_file(script_path.c_str(), scripts, sizeof(scripts) - 1);
+
+  // Process.
+  p.exec(perl_connector + " --in-process --workers 1");
+
+  // Write commands, the second one times out before the worker can
+  // start it.
+  static constexpr const char cmd4_short[] =
+      "\x00"
+      "1\x00"
+      "123456789\x00";
+  std::ostringstream oss;
+  oss.write(cmd3, sizeof(cmd3) - 1);
+  oss << "1";
+  oss.write(cmd4, sizeof(cmd4) - 1);
+  oss << busy_path;
+  oss.write(cmd5, sizeof(cmd5) - 1);
+  oss.write(cmd3, sizeof(cmd3) - 1);
+  oss << "2";
+  oss.write(cmd4_short, sizeof(cmd4_short) - 1);
+  oss << script_path;
+  oss.write(cmd5, sizeof(cmd5) - 1);
+  write_cmd(oss.str());
+
+  // Read reply.
+  std::string output{std::move(read_reply())};
+
+  int retval{wait_for_termination()};
+
+  // Remove temporary files.
+  remove(busy_path.c_str());
+  remove(script_path.c_str());
+
+  // The timed out check is reported first, without output.
+  static constexpr const char expected[] =
+      "3\x00"
+      "2\x00"
+      "1\x00"
+      "-1\x00"
+      " \x00"
+      " \x00\x00\x00\x00"
+      "3\x00"
+      "1\x00"
+      "1\x00"
+      "0\x00"
+      " \x00"
+      "Centreon is wonderful\n"
+      "\x00\x00\x00\x00";
+  ASSERT_EQ(retval, 0);
+  ASSERT_EQ(output, std::string(expected, sizeof(expected) - 1));
+}
+
+TEST_F(TestConnector, ExecuteInProcessTimeout) {
+  // Write Perl scripts. The second one times out after waiting for the
+  // first one in the worker, the worker must survive it.
+  std::string busy_path(io::file_stream::temp_path());
+  _write_file(busy_path.c_str(),
+              "#!/usr/bin/perl\n"
+              "# nagios: +epn\n"
+              "\n"
+              "sleep 1;\n"
+              "print \"Centreon is wonderful\\n\";\n"
+              "exit 0;\n");
+  std::string hang_path(io::file_stream::temp_path());
+  _write_file(hang_path.c_str(),
+              "#!/usr/bin/perl\n"
+              "# nagios: +epn\n"
+              "\n"
+              "sleep 10;\n"
+              "exit 0;\n");
+  std::string script_path(io::file_stream::temp_path());
+  _write_file(script_path.c_str(), scripts, sizeof(scripts) - 1);
+
+  // Process.
+  p.exec(perl_connector + " --in-process --workers 1");
+
+  // Write commands.
+  static constexpr const char cmd4_short[] =
+      "\x00"
+      "2\x00"
+      "123456789\x00";
+  std::ostringstream oss;
+  oss.write(cmd3, sizeof(cmd3) - 1);
+  oss << "1";
+  oss.write(cmd4, sizeof(cmd4) - 1);
+  oss << busy_path;
+  oss.write(cmd5, sizeof(cmd5) - 1);
+  oss.write(cmd3, sizeof(cmd3) - 1);
+  oss << "2";
+  oss.write(cmd4_short, sizeof(cmd4_short) - 1);
+  oss << hang_path;
+  oss.write(cmd5, sizeof(cmd5) - 1);
+  oss.write(cmd3, sizeof(cmd3) - 1);
+  oss << "3";
+  oss.write(cmd4, sizeof(cmd4) - 1);
+  oss << script_path;
+  oss.write(cmd5, sizeof(cmd5) - 1);
+  write_cmd(oss.str());
+
+  // Read reply.
+  std::string output{std::move(read_reply())};
+
+  int retval{wait_for_termination()};
+
+  // Remove temporary files.
+  remove(busy_path.c_str());
+  remove(hang_path.c_str());
+  remove(script_path.c_str());
+
+  // The last check still ran in the worker.
+  static constexpr const char expected[] =
+      "3\x00"
+      "1\x00"
+      "1\x00"
+      "0\x00"
+      " \x00"
+      "Centreon is wonderful\n"
+      "\x00\x00\x00\x00"
+      "3\x00"
+      "2\x00"
+      "1\x00"
+      "-1\x00"
+      " \x00"
+      " \x00\x00\x00\x00"
+      "3\x00"
+      "3\x00"
+      "1\x00"
+      "2\x00"
+      " \x00"
+      "Centreon is wonderful\n"
+      "\x00\x00\x00\x00";
+  ASSERT_EQ(retval, 0);
+  ASSERT_EQ(output, std::string(expected, sizeof(expected) - 1));
+}
+
+TEST_F(TestConnector, ExecuteInProcessBlockedWorker) {
+  // Write Perl scripts, the first one blocks its worker.
+  std::string busy_path(io::file_stream::temp_path());
+  _write_file(busy_path.c_str(),
+              "#!/usr/bin/perl\n"
+              "# nagios: +epn\n"
+              "\n"
+              "sleep 2;\n"
+              "print \"Centreon is wonderful\\n\";\n"
+              "exit 0;\n");
+  std::string script_path(io::file_stream::temp_path());
+  _write_file(script_path.c_str(), scripts, sizeof(scripts) - 1);
+
+  // Process.
+  p.exec(perl_connector + " --in-process");
+
+  // Block a worker.
+  auto order = [](unsigned int id, std::string const& path) {
+    std::ostringstream oss;
+    oss.write(cmd3, sizeof(cmd3) - 1);
+    oss << id;
+    oss.write(cmd4, sizeof(cmd4) - 1);
+    oss << path;
+    oss.write(cmd5, sizeof(cmd5) - 1);
+    return oss.str();
+  };
+  std::string cmd(order(1, busy_path));
+  for (unsigned int size(0); size < cmd.size();)
+    size += p.write(cmd.c_str() + size, cmd.size() - size);
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  // Both checks go to the other worker.
+  write_cmd(order(2, script_path) + order(3, script_path));
+
+  // Read reply.
+  std::string output{std::move(read_reply())};
+
+  int retval{wait_for_termination()};
+
+  // Remove temporary files.
+  remove(busy_path.c_str());
+  remove(script_path.c_str());
+
+  // The blocking check is reported last.
+  static constexpr const char last[] =
+      "3\x00"
+      "1\x00"
+      "1\x00"
+      "0\x00"
+      " \x00"
+      "Centreon is wonderful\n"
+      "\x00\x00\x00\x00";
+  ASSERT_EQ(retval, 0);
+  ASSERT_EQ(output.size(), 3 * (sizeof(last) - 1));
+  ASSERT_EQ(output.substr(output.size() - (sizeof(last) - 1)),
+            std::string(last, sizeof(last) - 1));
+}
+
+TEST_F(TestConnector, ExecuteInProcessTruncated) {
+  // Write Perl script, its output does not fit in a worker message.
+  std::string script_path(io::file_stream::temp_path());
+  _write_file(script_path.c_str(),
+              "#!/usr/bin/perl\n"
+              "# nagios: +epn\n"
+              "\n"
+              "print \"x\" x 100000;\n"
+              "exit 0;\n");
+
+  // Process.
+  p.exec(perl_connector + " --in-process");
+
+  // Write command.
+  std::ostringstream oss;
+  oss.write(cmd1, sizeof(cmd1) - 1);
+  oss << script_path;
+  oss.write(cmd2, sizeof(cmd2) - 1);
+  write_cmd(oss.str());
+
+  // Read reply.
+  std::string output{std::move(read_reply())};
+
+  int retval{wait_for_termination()};
+
+  // Remove temporary files.
+  remove(script_path.c_str());
+
+  // The cut output is marked and the check is unknown.
+  static constexpr const char head[] =
+      "3\x00"
+      "4242\x00"
+      "1\x00"
+      "3\x00"
+      " \x00"
+      "xxxxxxxx";
+  static constexpr const char tail[] = "x\n(output truncated)\x00\x00\x00\x00";
+  ASSERT_EQ(retval, 0);
+  ASSERT_GT(output.size(), sizeof(head) + sizeof(tail));
+  ASSERT_EQ(output.substr(0, sizeof(head) - 1),
+            std::string(head, sizeof(head) - 1));
+  ASSERT_EQ(output.substr(output.size() - (sizeof(tail) - 1)),
+            std::string(tail, sizeof(tail) - 1));
+}
+
+TEST_F(TestConnector, ExecuteMemfd) {
+  // Write Perl script.
+  std::string script_path(io::file_stream::temp_path());
+  _write_file(
+      script_path.c_str(),
+      "#!/usr/bin/perl\n"
+      "\n"
+      "print \"$Centreon::Test::company is $Centreon::Test::attribute\\n\";\n"
+      "exit 0;\n");
+
+  // Process.
+  p.exec(
+      perl_connector +
+      " --memfd --code 'package Centreon::Test; our $company=\"Centreon\"; "
+      "our $attribute=\"wonderful\";'");
+
+  // Write command.
+  std::ostringstream oss;
+  oss.write(cmd1, sizeof(cmd1) - 1);
+  oss << script_path;
+  oss.write(cmd2, sizeof(cmd2) - 1);
+  write_cmd(oss.str());
+
+  // Read reply.
+  std::string output{std::move(read_reply())};
+
+  int retval{wait_for_termination()};
+
+  // Remove temporary files.
+  remove(script_path.c_str());
+
+  ASSERT_EQ(retval, 0);
+  ASSERT_EQ(output.size(), (sizeof(result) - 1));
+  ASSERT_FALSE(memcmp(output.c_str(), result, sizeof(result) - 1));
+}
+
+TEST_F(TestConnector, ExecuteWarmUp) {
+  // Write Perl script.
+  std::string script_path(io::file_stream::temp_path());
+  _write_file(
+      script_path.c_str(),
+      "#!/usr/bin/perl\n"
+      "\n"
+      "print \"$Centreon::Test::company is $Centreon::Test::attribute\\n\";\n"
+      "exit 0;\n");
+  std::string manifest_path(io::file_stream::temp_path());
+
+  // Process.
+  p.exec(perl_connector + " --warm-up-file " + manifest_path +
+         " --code 'package Centreon::Test; our $company=\"Centreon\"; "
+         "our $attribute=\"wonderful\";'");
+
+  // Write command.
+  std::ostringstream oss;
+  oss.write(cmd1, sizeof(cmd1) - 1);
+  oss << script_path;
+  oss.write(cmd2, sizeof(cmd2) - 1);
+  write_cmd(oss.str());
+
+  // Read reply.
+  std::string output{std::move(read_reply())};
+
+  int retval{wait_for_termination()};
+
+  // The script is recorded for the next startup.
+  std::ifstream manifest(manifest_path);
+  std::string recorded;
+  std::getline(manifest, recorded);
+
+  // Remove temporary files.
+  remove(script_path.c_str());
+  remove(manifest_path.c_str());
+
+  ASSERT_EQ(retval, 0);
+  ASSERT_EQ(output.size(), (sizeof(result) - 1));
+  ASSERT_FALSE(memcmp(output.c_str(), result, sizeof(result) - 1));
+  ASSERT_EQ(recorded, script_path);
+}
+
 TEST_F(TestConnector, NonExistantScript) {
   // Process.
   p.exec(perl_connector);
@@ -388,6 +1012,40 @@ TEST_F(TestConnector, NonExistantScript) {
       memcmp(output.c_str(), NonExistantRESULT, sizeof(NonExistantRESULT) - 1));
 }
 
+TEST_F(TestConnector, OutputTruncated) {
+  // Write Perl script.
+  std::string script_path(io::file_stream::temp_path());
+  _write_file(script_path.c_str(),
+              "#!/usr/bin/perl\n"
+              "\n"
+              "print \"x\" x 65536;\n"
+              "sleep 10;\n"
+              "exit 0;\n");
+
+  // Process.
+  p.exec(perl_connector + " --max-output-size 16");
+
+  // Write command.
+  std::ostringstream oss;
+  oss.write(cmd1, sizeof(cmd1) - 1);
+  oss << script_path;
+  oss.write(cmd2, sizeof(cmd2) - 1);
+  write_cmd(oss.str());
+
+  // Read reply.
+  std::string output{std::move(read_reply())};
+
+  int retval{wait_for_termination()};
+
+  // Remove temporary files.
+  remove(script_path.c_str());
+
+  ASSERT_EQ(retval, 0);
+  ASSERT_EQ(output.size(), sizeof(OutputTruncatedRESULT) - 1);
+  ASSERT_FALSE(memcmp(output.c_str(), OutputTruncatedRESULT,
+                      sizeof(OutputTruncatedRESULT) - 1));
+}
+
 /**
  *  Check that connector properly kills timeouting processes.
  *
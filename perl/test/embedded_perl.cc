@@ -44,7 +44,7 @@ TEST(EmbeddedPerl, RunSimple1) {
     } while ((rb > 0) && (size > 0));
 
     // Compile and execute script.
-    int fds[3];
+    int fds[2];
     pid_t child(embedded_perl::instance().run(script_path, fds));
 
     // Wait for child termination.
@@ -83,7 +83,7 @@ TEST(EmbeddedPerl, RunSimple2) {
     } while ((rb > 0) && (size > 0));
 
     // Compile and execute script.
-    int fds[3];
+    int fds[2];
     pid_t child(embedded_perl::instance().run(script_path, fds));
 
     // Wait for child termination.
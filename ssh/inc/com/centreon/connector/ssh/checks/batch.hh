@@ -0,0 +1,60 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#ifndef CCCS_CHECKS_BATCH_HH
+#define CCCS_CHECKS_BATCH_HH
+
+#include <string>
+#include <vector>
+#include "com/centreon/connector/ssh/checks/result.hh"
+#include "com/centreon/connector/ssh/namespace.hh"
+
+CCCS_BEGIN()
+
+namespace checks {
+/**
+ *  @class batch batch.hh "com/centreon/connector/ssh/checks/batch.hh"
+ *  @brief Aggregate results of a fan-out order.
+ *
+ *  A fan-out order runs one command on several hosts. Per-host results
+ *  are collected here by host index and merged into a single result
+ *  reported under the command ID of the order.
+ */
+class batch {
+ public:
+  batch(unsigned long long cmd_id, std::vector<std::string> const& hosts);
+  batch(batch const& b) = delete;
+  ~batch() = default;
+  batch& operator=(batch const& b) = delete;
+  bool add(size_t index, result const& r);
+  unsigned long long get_command_id() const noexcept;
+  result get_result() const;
+  bool is_complete() const noexcept;
+
+ private:
+  unsigned long long _cmd_id;
+  std::vector<std::string> _hosts;
+  std::vector<bool> _received;
+  size_t _remaining;
+  std::vector<result> _results;
+};
+}  // namespace checks
+
+CCCS_END()
+
+#endif  // !CCCS_CHECKS_BATCH_HH
@@ -0,0 +1,87 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#ifndef CCCS_CHECKS_BUILTIN_HH
+#define CCCS_CHECKS_BUILTIN_HH
+
+#include <cstdint>
+#include <ctime>
+#include <regex>
+#include <string>
+#include "com/centreon/connector/ssh/checks/result.hh"
+#include "com/centreon/connector/ssh/namespace.hh"
+
+CCCS_BEGIN()
+
+namespace checks {
+/**
+ *  @class builtin builtin.hh "com/centreon/connector/ssh/checks/builtin.hh"
+ *  @brief Built-in check primitive.
+ *
+ *  Built-in checks are evaluated by the connector from file data
+ *  fetched over SFTP, no process is run on the remote host. Supported
+ *  primitives are :
+ *
+ *    file-age    <path> [<warning> [<critical>]]
+ *    file-size   <path> [<warning> [<critical>]]
+ *    proc-file   <path> <field> [<warning> [<critical>]]
+ *    regex-count <path> <regex> [<warning> [<critical>]]
+ *
+ *  The state is WARNING or CRITICAL when the measured value is greater
+ *  than the matching threshold. A proc-file field is either the n-th
+ *  whitespace-separated token of the file or the first number of the
+ *  line starting with this name (like MemAvailable in /proc/meminfo).
+ *  regex-count counts the lines matching an ECMAScript regex.
+ */
+class builtin {
+ public:
+  enum e_type { file_age = 0, file_size, proc_file, regex_count };
+
+  builtin(std::string const& cmdline);
+  builtin(builtin const& b) = delete;
+  ~builtin() = default;
+  builtin& operator=(builtin const& b) = delete;
+  result evaluate(uint64_t size,
+                  time_t mtime,
+                  std::string const& content,
+                  time_t now) const;
+  std::string const& get_path() const noexcept;
+  e_type get_type() const noexcept;
+  result make_result(int exit_code, std::string const& message) const;
+  bool needs_content() const noexcept;
+
+ private:
+  double _measure(uint64_t size,
+                  time_t mtime,
+                  std::string const& content,
+                  time_t now) const;
+
+  double _critical;
+  std::string _field;
+  bool _has_critical;
+  bool _has_warning;
+  std::string _path;
+  std::regex _regex;
+  e_type _type;
+  double _warning;
+};
+}  // namespace checks
+
+CCCS_END()
+
+#endif  // !CCCS_CHECKS_BUILTIN_HH
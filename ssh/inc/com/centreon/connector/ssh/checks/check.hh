@@ -21,8 +21,12 @@
 
 #include <ctime>
 #include <list>
+#include <memory>
 #include <string>
+#include "com/centreon/connector/ssh/checks/builtin.hh"
 #include "com/centreon/connector/ssh/checks/listener.hh"
+#include "com/centreon/connector/ssh/checks/output_filter.hh"
+#include "com/centreon/connector/ssh/checks/timeout.hh"
 #include "com/centreon/connector/ssh/namespace.hh"
 #include "com/centreon/connector/ssh/sessions/listener.hh"
 #include "com/centreon/connector/ssh/sessions/session.hh"
@@ -38,16 +42,22 @@ class result;
  *  @class check check.hh "com/centreon/connector/ssh/checks/check.hh"
  *  @brief Execute a check on a host.
  *
- *  Execute a check by opening a new channel on a SSH session.
+ *  Execute a check by opening a new channel on a SSH session. Built-in
+ *  checks are evaluated from files fetched through the SFTP subsystem
+ *  of the session instead.
  */
 class check : public sessions::listener {
  public:
-  check(int skip_stdout = -1, int skip_stderr = -1);
+  check(int skip_stdout = -1,
+        int skip_stderr = -1,
+        size_t max_output_size = 0,
+        bool use_builtin = false);
   ~check() noexcept override;
   void execute(sessions::session& sess,
                unsigned long long cmd_id,
                std::list<std::string> const& cmds,
                const timestamp& tmt);
+  timestamp const& get_deadline() const noexcept override;
   void listen(checks::listener* listnr);
   void on_available(sessions::session& sess) override;
   void on_close(sessions::session& sess) override;
@@ -56,7 +66,16 @@ class check : public sessions::listener {
   void unlisten(checks::listener* listnr);
 
  private:
-  enum e_step { chan_open = 1, chan_exec, chan_read, chan_close };
+  enum e_step {
+    chan_open = 1,
+    chan_exec,
+    chan_read,
+    chan_close,
+    sftp_stat,
+    sftp_open,
+    sftp_read,
+    sftp_close
+  };
 
   check(check const& c);
   check& operator=(check const& c);
@@ -64,20 +83,26 @@ class check : public sessions::listener {
   bool _exec();
   bool _open();
   bool _read();
-  void _send_result_and_unregister(result const& r);
-  static std::string& _skip_data(std::string& data, int nb_line);
+  void _send_result_and_unregister(result& r);
+  bool _sftp();
 
+  std::unique_ptr<builtin> _builtin;
   LIBSSH2_CHANNEL* _channel;
   std::list<std::string> _cmds;
   unsigned long long _cmd_id;
+  std::string _content;
+  timestamp _deadline;
+  LIBSSH2_SFTP_HANDLE* _file;
+  time_t _file_mtime;
+  uint64_t _file_size;
   checks::listener* _listnr;
   sessions::session* _session;
   int _skip_stderr;
-  int _skip_stdout;
-  std::string _stderr;
-  std::string _stdout;
+  output_filter _stderr;
+  output_filter _stdout;
   e_step _step;
-  unsigned long _timeout;
+  timeout _timeout;
+  bool _use_builtin;
 };
 }  // namespace checks
 
@@ -29,7 +29,8 @@ namespace checks {
  *  @class listener listener.hh "com/centreon/connector/ssh/checks/listener.hh"
  *  @brief Check listener.
  *
- *  Listen check events.
+ *  Listen check events. The listener owns the result it is given and
+ *  can move its content.
  */
 class listener {
  public:
@@ -37,7 +38,7 @@ class listener {
   listener(listener const& l) = delete;
   virtual ~listener() = default;
   listener& operator=(listener const& l) = delete;
-  virtual void on_result(result const& result) = 0;
+  virtual void on_result(result& result) = 0;
 };
 }  // namespace checks
 
@@ -0,0 +1,61 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#ifndef CCCS_CHECKS_OUTPUT_FILTER_HH
+#define CCCS_CHECKS_OUTPUT_FILTER_HH
+
+#include <cstddef>
+#include <string>
+#include "com/centreon/connector/ssh/namespace.hh"
+
+CCCS_BEGIN()
+
+namespace checks {
+/**
+ *  @class output_filter output_filter.hh
+ * "com/centreon/connector/ssh/checks/output_filter.hh"
+ *  @brief Filter a command output while it is read.
+ *
+ *  Keep only the first lines of an output stream, up to a maximum
+ *  size. Data past the limits is dropped as soon as it arrives.
+ */
+class output_filter {
+ public:
+  output_filter(int max_lines = -1, size_t max_size = 0);
+  output_filter(output_filter const& of) = delete;
+  ~output_filter() = default;
+  output_filter& operator=(output_filter const& of) = delete;
+  void append(char const* data, size_t size);
+  std::string const& get_data() const noexcept;
+  bool is_full() const noexcept;
+  bool is_truncated() const noexcept;
+  std::string release();
+
+ private:
+  std::string _data;
+  bool _full;
+  int _lines_left;
+  size_t _max_size;
+  size_t _received;
+  bool _truncated;
+};
+}  // namespace checks
+
+CCCS_END()
+
+#endif  // !CCCS_CHECKS_OUTPUT_FILTER_HH
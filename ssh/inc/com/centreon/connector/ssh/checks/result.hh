@@ -35,8 +35,10 @@ class result {
  public:
   result();
   result(result const& r);
+  result(result&& r) noexcept;
   ~result() = default;
   result& operator=(result const& r);
+  result& operator=(result&& r) noexcept;
   unsigned long long get_command_id() const noexcept;
   std::string const& get_error() const noexcept;
   bool get_executed() const noexcept;
@@ -44,9 +46,11 @@ class result {
   std::string const& get_output() const noexcept;
   void set_command_id(unsigned long long cmd_id) noexcept;
   void set_error(std::string const& error);
+  void set_error(std::string&& error) noexcept;
   void set_executed(bool executed) noexcept;
   void set_exit_code(int code) noexcept;
   void set_output(std::string const& output);
+  void set_output(std::string&& output) noexcept;
 
  private:
   void _internal_copy(result const& r);
@@ -21,7 +21,7 @@
 
 #include <cstddef>
 #include "com/centreon/connector/ssh/namespace.hh"
-#include "com/centreon/task.hh"
+#include "com/centreon/connector/timer_wheel.hh"
 
 CCCS_BEGIN()
 
@@ -33,9 +33,9 @@ class check;
  *  @class timeout timeout.hh "com/centreon/connector/ssh/checks/timeout.hh"
  *  @brief Check timeout.
  *
- *  Task executed when a check timeouts.
+ *  Timer embedded in a check, run when the check timeouts.
  */
-class timeout : public com::centreon::task {
+class timeout : public com::centreon::connector::timer {
   check* _check;
 
  public:
@@ -19,8 +19,9 @@
 #ifndef CCCS_MULTIPLEXER_HH
 #define CCCS_MULTIPLEXER_HH
 
+#include "com/centreon/connector/reactor.hh"
+#include "com/centreon/connector/timer_wheel.hh"
 #include "com/centreon/connector/ssh/namespace.hh"
-#include "com/centreon/handle_manager.hh"
 #include "com/centreon/task_manager.hh"
 
 CCCS_BEGIN()
@@ -30,11 +31,14 @@ CCCS_BEGIN()
  * "com/centreon/connector/ssh/multiplexer.hh"
  *  @brief Multiplexing class.
  *
- *  Singleton that aggregates multiplexing features such as file
- *  descriptor monitoring and task execution.
+ *  Per-thread singleton that aggregates multiplexing features such as
+ *  file descriptor monitoring, timers and task execution. Each thread
+ *  running sessions loads its own instance, instance() returns the one
+ *  of the calling thread.
  */
 class multiplexer : public com::centreon::task_manager,
-                    public com::centreon::handle_manager {
+                    public com::centreon::connector::timer_wheel,
+                    public com::centreon::connector::reactor {
   multiplexer();
 
  public:
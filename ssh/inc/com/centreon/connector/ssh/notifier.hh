@@ -0,0 +1,60 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#ifndef CCCS_NOTIFIER_HH
+#define CCCS_NOTIFIER_HH
+
+#include <functional>
+#include "com/centreon/connector/ssh/namespace.hh"
+#include "com/centreon/handle.hh"
+#include "com/centreon/handle_listener.hh"
+
+CCCS_BEGIN()
+
+/**
+ *  @class notifier notifier.hh "com/centreon/connector/ssh/notifier.hh"
+ *  @brief Wake up a multiplexer from another thread.
+ *
+ *  Wrapper around an eventfd. Any thread can call notify(), the
+ *  callback is then run by the thread multiplexing the notifier.
+ */
+class notifier : public com::centreon::handle,
+                 public com::centreon::handle_listener {
+ public:
+  notifier(std::function<void()> callback);
+  notifier(notifier const& n) = delete;
+  ~notifier() noexcept override;
+  notifier& operator=(notifier const& n) = delete;
+  void close() override;
+  void error(handle& h) override;
+  native_handle get_native_handle() override;
+  void notify();
+  unsigned long read(void* data, unsigned long size) override;
+  void read(handle& h) override;
+  bool want_read(handle& h) override;
+  bool want_write(handle& h) override;
+  unsigned long write(void const* data, unsigned long size) override;
+
+ private:
+  std::function<void()> _callback;
+  native_handle _fd;
+};
+
+CCCS_END()
+
+#endif  // !CCCS_NOTIFIER_HH
@@ -36,6 +36,8 @@ class options : public com::centreon::misc::get_options {
   options(options const& opts);
   ~options() noexcept override;
   options& operator=(options const& opts);
+  unsigned int get_unsigned(std::string const& long_name,
+                            unsigned int default_value = 0) const;
   std::string help() const override;
   void parse(int argc, char* argv[]);
   std::string usage() const override;
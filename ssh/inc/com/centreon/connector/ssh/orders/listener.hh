@@ -22,6 +22,7 @@
 #include <ctime>
 #include <list>
 #include <string>
+#include <vector>
 #include "com/centreon/connector/ssh/namespace.hh"
 #include "com/centreon/timestamp.hh"
 
@@ -53,7 +54,22 @@ class listener {
                           std::list<std::string> const& cmds,
                           int skip_stdout,
                           int skip_stderr,
-                          bool is_ipv6) = 0;
+                          bool is_ipv6,
+                          bool compress,
+                          bool builtin) = 0;
+  virtual void on_execute_many(uint64_t cmd_id,
+                               const timestamp& timeout,
+                               std::vector<std::string> const& hosts,
+                               unsigned short port,
+                               std::string const& user,
+                               std::string const& password,
+                               std::string const& identity,
+                               std::list<std::string> const& cmds,
+                               int skip_stdout,
+                               int skip_stderr,
+                               bool is_ipv6,
+                               bool compress,
+                               bool builtin) = 0;
   virtual void on_quit() = 0;
   virtual void on_version() = 0;
 };
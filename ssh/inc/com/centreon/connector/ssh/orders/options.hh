@@ -41,7 +41,9 @@ class options {
   ~options() noexcept = default;
   options& operator=(options const& p) = delete;
   std::string const& get_authentication() const noexcept;
+  bool get_builtin() const noexcept;
   std::list<std::string> const& get_commands() const noexcept;
+  bool get_compress() const noexcept;
   std::string const& get_host() const noexcept;
   std::string const& get_identity_file() const noexcept;
   ip_protocol get_ip_protocol() const noexcept;
@@ -58,7 +60,9 @@ class options {
   static std::string _get_user_name();
 
   std::string _authentication;
+  bool _builtin;
   std::list<std::string> _commands;
+  bool _compress;
   std::string _host;
   std::string _identity_file;
   ip_protocol _ip_protocol;
@@ -19,6 +19,7 @@
 #ifndef CCCS_ORDERS_PARSER_HH
 #define CCCS_ORDERS_PARSER_HH
 
+#include <cstdint>
 #include <string>
 #include "com/centreon/connector/ssh/namespace.hh"
 #include "com/centreon/connector/ssh/orders/listener.hh"
@@ -33,7 +34,8 @@ namespace orders {
  *
  *  Parse orders, generally issued by the monitoring engine. The
  *  parser class can handle be registered with one handle at a time
- *  and one listener.
+ *  and one listener. Command IDs from first_reserved_id are reserved
+ *  for checks the connector creates itself and are rejected.
  */
 class parser : public handle_listener {
   std::string _buffer;
@@ -42,6 +44,8 @@ class parser : public handle_listener {
   void _parse(std::string const& cmd);
 
  public:
+  static constexpr uint64_t first_reserved_id = 1ULL << 63;
+
   parser();
   ~parser() noexcept {};
   parser(parser const& p) = delete;
@@ -19,37 +19,38 @@
 #ifndef CCCS_POLICY_HH
 #define CCCS_POLICY_HH
 
-#include <map>
-#include <mutex>
-#include <utility>
-#include "com/centreon/connector/ssh/checks/listener.hh"
+#include <memory>
+#include <vector>
+#include "com/centreon/connector/mpsc_queue.hh"
+#include "com/centreon/connector/ssh/checks/batch.hh"
+#include "com/centreon/connector/ssh/checks/result.hh"
+#include "com/centreon/connector/ssh/notifier.hh"
 #include "com/centreon/connector/ssh/orders/listener.hh"
 #include "com/centreon/connector/ssh/orders/parser.hh"
 #include "com/centreon/connector/ssh/reporter.hh"
-#include "com/centreon/connector/ssh/sessions/credentials.hh"
+#include "com/centreon/connector/ssh/sessions/agent_cache.hh"
+#include "com/centreon/connector/ssh/sessions/handshake_limiter.hh"
+#include "com/centreon/connector/ssh/worker.hh"
 #include "com/centreon/io/file_stream.hh"
 #include "com/centreon/timestamp.hh"
+#include "com/centreon/unordered_hash.hh"
 
 CCCS_BEGIN()
 
 // Forward declarations.
-namespace checks {
-class check;
-class result;
-}  // namespace checks
-namespace sessions {
-class session;
-}
+class options;
 
 /**
  *  @class policy policy.hh "com/centreon/connector/ssh/policy.hh"
  *  @brief Software policy.
  *
- *  Manage program execution.
+ *  Manage program execution. Orders are read and results are reported
+ *  by the main thread, checks are dispatched to workers according to
+ *  their credentials so that a session always runs in the same thread.
  */
-class policy : public orders::listener, public checks::listener {
+class policy : public orders::listener {
  public:
-  policy();
+  policy(options const& opts);
   ~policy() noexcept override;
   void on_eof() override;
   void on_error(uint64_t cmd_id, char const* msg) override;
@@ -63,24 +64,57 @@ class policy : public orders::listener, public checks::listener {
                   std::list<std::string> const& cmds,
                   int skip_output,
                   int skip_error,
-                  bool is_ipv6) override;
+                  bool is_ipv6,
+                  bool compress,
+                  bool builtin) override;
+  void on_execute_many(uint64_t cmd_id,
+                       const timestamp& timeout,
+                       std::vector<std::string> const& hosts,
+                       unsigned short port,
+                       std::string const& user,
+                       std::string const& password,
+                       std::string const& key,
+                       std::list<std::string> const& cmds,
+                       int skip_output,
+                       int skip_error,
+                       bool is_ipv6,
+                       bool compress,
+                       bool builtin) override;
   void on_quit() override;
-  void on_result(checks::result const& r) override;
   void on_version() override;
   bool run();
 
  private:
+  /**
+   *  Host of a fan-out order, run under a command ID of the reserved
+   *  range. Its result goes to the batch of the order.
+   */
+  struct fan_out_host {
+    std::shared_ptr<checks::batch> b;
+    size_t index;
+  };
+
   policy(policy const& p);
   policy& operator=(policy const& p);
+  static std::string _agent_socket();
+  void _dispatch(worker::order&& o);
+  void _report_results();
+  bool _workers_failed();
 
-  std::map<uint64_t, std::pair<checks::check*, sessions::session*> > _checks;
+  sessions::agent_cache _agents;
+  bool _compress;
   bool _error;
-  std::mutex _mutex;
+  umap<unsigned long long, fan_out_host> _fan_outs;
+  size_t _in_flight;
+  sessions::handshake_limiter _limiter;
+  unsigned long long _next_id;
   orders::parser _parser;
   reporter _reporter;
-  std::map<sessions::credentials, sessions::session*> _sessions;
+  mpsc_queue<checks::result> _results;
+  notifier _results_notifier;
   io::file_stream _sin;
   io::file_stream _sout;
+  std::vector<std::unique_ptr<worker> > _workers;
 };
 
 CCCS_END()
@@ -0,0 +1,65 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#ifndef CCCS_SESSIONS_AGENT_CACHE_HH
+#define CCCS_SESSIONS_AGENT_CACHE_HH
+
+#include <mutex>
+#include <string>
+#include "com/centreon/connector/ssh/namespace.hh"
+#include "com/centreon/connector/ssh/sessions/credentials.hh"
+#include "com/centreon/unordered_hash.hh"
+
+CCCS_BEGIN()
+
+namespace sessions {
+/**
+ *  @class agent_cache agent_cache.hh
+ * "com/centreon/connector/ssh/sessions/agent_cache.hh"
+ *  @brief Remember which ssh-agent identity opens which destination.
+ *
+ *  The ssh-agent may hold many identities. The public key blob of the
+ *  identity accepted by a destination is kept so that later
+ *  connections to the same destination try it first. The cache is
+ *  shared by all worker threads.
+ */
+class agent_cache {
+ public:
+  agent_cache(std::string const& socket_path = std::string());
+  agent_cache(agent_cache const& ac) = delete;
+  ~agent_cache() = default;
+  agent_cache& operator=(agent_cache const& ac) = delete;
+  void forget(credentials const& creds);
+  std::string get_identity(credentials const& creds) const;
+  std::string const& get_socket_path() const noexcept;
+  bool is_enabled() const noexcept;
+  void set_identity(credentials const& creds, std::string const& blob);
+  size_t size() const;
+
+ private:
+  static std::string _key(credentials const& creds);
+
+  umap<std::string, std::string> _identities;
+  mutable std::mutex _mutex;
+  std::string _socket_path;
+};
+}  // namespace sessions
+
+CCCS_END()
+
+#endif  // !CCCS_SESSIONS_AGENT_CACHE_HH
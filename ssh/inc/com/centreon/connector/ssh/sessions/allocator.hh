@@ -0,0 +1,68 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#ifndef CCCS_SESSIONS_ALLOCATOR_HH
+#define CCCS_SESSIONS_ALLOCATOR_HH
+
+#include <libssh2.h>
+#include <atomic>
+#include <cstddef>
+#include "com/centreon/connector/ssh/namespace.hh"
+
+CCCS_BEGIN()
+
+namespace sessions {
+/**
+ *  @class allocator allocator.hh
+ * "com/centreon/connector/ssh/sessions/allocator.hh"
+ *  @brief libssh2 memory allocator of a session.
+ *
+ *  Serve the allocations of a libssh2 session from per-thread pools of
+ *  fixed size blocks, larger requests go to the heap. Freed blocks are
+ *  kept for reuse instead of fragmenting the heap. Memory used is
+ *  accounted per session and for all sessions.
+ */
+class allocator {
+ public:
+  allocator();
+  allocator(allocator const& a) = delete;
+  ~allocator() noexcept;
+  allocator& operator=(allocator const& a) = delete;
+  void* allocate(size_t size);
+  void deallocate(void* ptr) noexcept;
+  size_t get_allocated() const noexcept;
+  size_t get_peak() const noexcept;
+  static size_t get_total_allocated() noexcept;
+  void* reallocate(void* ptr, size_t size);
+
+  static LIBSSH2_ALLOC_FUNC(libssh2_alloc);
+  static LIBSSH2_FREE_FUNC(libssh2_free);
+  static LIBSSH2_REALLOC_FUNC(libssh2_realloc);
+
+ private:
+  void _account(size_t released, size_t acquired) noexcept;
+
+  size_t _allocated;
+  size_t _peak;
+  static std::atomic<size_t> _total;
+};
+}  // namespace sessions
+
+CCCS_END()
+
+#endif  // !CCCS_SESSIONS_ALLOCATOR_HH
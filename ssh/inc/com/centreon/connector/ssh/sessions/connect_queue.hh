@@ -0,0 +1,74 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#ifndef CCCS_SESSIONS_CONNECT_QUEUE_HH
+#define CCCS_SESSIONS_CONNECT_QUEUE_HH
+
+#include <list>
+#include "com/centreon/connector/ssh/namespace.hh"
+#include "com/centreon/connector/ssh/sessions/handshake_limiter.hh"
+#include "com/centreon/task.hh"
+#include "com/centreon/timestamp.hh"
+#include "com/centreon/unordered_hash.hh"
+
+CCCS_BEGIN()
+
+namespace sessions {
+// Forward declaration.
+class session;
+
+/**
+ *  @class connect_queue connect_queue.hh
+ * "com/centreon/connector/ssh/sessions/connect_queue.hh"
+ *  @brief Queue of sessions waiting to connect.
+ *
+ *  Sessions are connected as soon as the handshake limiter allows
+ *  it, earliest deadline first. Checks of a queued session keep
+ *  waiting on it and their own timeout still applies.
+ */
+class connect_queue : public com::centreon::task {
+ public:
+  connect_queue(handshake_limiter& limiter);
+  connect_queue(connect_queue const& cq) = delete;
+  ~connect_queue() noexcept override;
+  connect_queue& operator=(connect_queue const& cq) = delete;
+  void cancel(session* sess);
+  void connect(session* sess, bool use_ipv6, timestamp const& deadline);
+  void run() override;
+  size_t size() const noexcept;
+
+ private:
+  struct pending {
+    session* sess;
+    bool use_ipv6;
+    timestamp deadline;
+  };
+
+  void _drain();
+  static void _start(pending const& p);
+
+  umap<session*, std::list<pending>::iterator> _index;
+  handshake_limiter& _limiter;
+  std::list<pending> _pending;
+  unsigned long _task_id;
+};
+}  // namespace sessions
+
+CCCS_END()
+
+#endif  // !CCCS_SESSIONS_CONNECT_QUEUE_HH
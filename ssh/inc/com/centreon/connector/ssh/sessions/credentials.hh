@@ -19,6 +19,8 @@
 #ifndef CCCS_SESSIONS_CREDENTIALS_HH
 #define CCCS_SESSIONS_CREDENTIALS_HH
 
+#include <cstddef>
+#include <functional>
 #include <string>
 #include "com/centreon/connector/ssh/namespace.hh"
 
@@ -31,7 +33,11 @@ namespace sessions {
  *  @brief Connection credentials.
  *
  *  Bundle together connection credentials : host, user and
- *  password. Methods are provided so that they can be compared.
+ *  password. Transport options that cannot be changed on an
+ *  established session (compression) are part of credentials too so
+ *  that sessions using different options are not shared. Methods
+ *  are provided so that they can be compared or hashed. The hash is
+ *  computed each time a member changes.
  */
 class credentials {
  public:
@@ -47,11 +53,14 @@ class credentials {
   bool operator==(credentials const& c) const;
   bool operator!=(credentials const& c) const;
   bool operator<(credentials const& c) const;
+  bool get_compress() const;
   std::string const& get_key() const;
   std::string const& get_host() const;
   std::string const& get_password() const;
   unsigned short get_port() const;
   std::string const& get_user() const;
+  size_t hash() const noexcept;
+  void set_compress(bool compress);
   void set_host(std::string const& host);
   void set_key(std::string const& file);
   void set_password(std::string const& password);
@@ -60,7 +69,10 @@ class credentials {
 
  private:
   void _copy(credentials const& c);
+  void _update_hash();
 
+  bool _compress;
+  size_t _hash;
   std::string _host;
   std::string _key;
   std::string _password;
@@ -71,4 +83,14 @@ class credentials {
 
 CCCS_END()
 
+namespace std {
+template <>
+struct hash<com::centreon::connector::ssh::sessions::credentials> {
+  size_t operator()(com::centreon::connector::ssh::sessions::credentials const&
+                        c) const noexcept {
+    return c.hash();
+  }
+};
+}  // namespace std
+
 #endif  // !CCCS_SESSIONS_CREDENTIALS_HH
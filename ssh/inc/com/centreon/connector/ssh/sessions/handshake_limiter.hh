@@ -0,0 +1,62 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#ifndef CCCS_SESSIONS_HANDSHAKE_LIMITER_HH
+#define CCCS_SESSIONS_HANDSHAKE_LIMITER_HH
+
+#include <mutex>
+#include <string>
+#include "com/centreon/connector/ssh/namespace.hh"
+#include "com/centreon/connector/ssh/sessions/token_bucket.hh"
+#include "com/centreon/unordered_hash.hh"
+
+CCCS_BEGIN()
+
+namespace sessions {
+/**
+ *  @class handshake_limiter handshake_limiter.hh
+ * "com/centreon/connector/ssh/sessions/handshake_limiter.hh"
+ *  @brief Limit the rate of new SSH handshakes.
+ *
+ *  Account new SSH handshakes globally and per destination host with
+ *  token buckets. The limiter is shared by all worker threads.
+ */
+class handshake_limiter {
+ public:
+  handshake_limiter(unsigned int rate = 0, unsigned int host_rate = 0);
+  handshake_limiter(handshake_limiter const& hl) = delete;
+  ~handshake_limiter() = default;
+  handshake_limiter& operator=(handshake_limiter const& hl) = delete;
+  bool acquire(std::string const& host, std::chrono::milliseconds& wait);
+  bool is_enabled() const noexcept;
+  bool is_saturated();
+
+ private:
+  void _prune(token_bucket::clock::time_point now);
+
+  token_bucket _global;
+  unsigned int _host_rate;
+  umap<std::string, token_bucket> _hosts;
+  std::mutex _mutex;
+  size_t _prune_size;
+};
+}  // namespace sessions
+
+CCCS_END()
+
+#endif  // !CCCS_SESSIONS_HANDSHAKE_LIMITER_HH
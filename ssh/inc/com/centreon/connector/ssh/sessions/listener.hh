@@ -20,6 +20,7 @@
 #define CCCS_SESSIONS_LISTENER_HH
 
 #include "com/centreon/connector/ssh/namespace.hh"
+#include "com/centreon/timestamp.hh"
 
 CCCS_BEGIN()
 
@@ -32,7 +33,9 @@ class session;
  * "com/centreon/connector/ssh/sessions/listener.hh"
  *  @brief Session listener.
  *
- *  Listen session events.
+ *  Listen session events. Listeners are notified earliest deadline
+ *  first, so that urgent checks get channels before the others. The
+ *  deadline must not change while the listener is registered.
  */
 class listener {
  public:
@@ -40,6 +43,7 @@ class listener {
   virtual ~listener() = default;
   listener(listener const& l) = delete;
   listener& operator=(listener const& l) = delete;
+  virtual timestamp const& get_deadline() const noexcept = 0;
   virtual void on_available(session& s) = 0;
   virtual void on_close(session& s) = 0;
   virtual void on_connected(session& s) = 0;
@@ -20,8 +20,11 @@
 #define CCCS_SESSIONS_SESSION_HH
 
 #include <libssh2.h>
+#include <libssh2_sftp.h>
 #include <set>
+#include <vector>
 #include "com/centreon/connector/ssh/namespace.hh"
+#include "com/centreon/connector/ssh/sessions/allocator.hh"
 #include "com/centreon/connector/ssh/sessions/credentials.hh"
 #include "com/centreon/connector/ssh/sessions/listener.hh"
 #include "com/centreon/connector/ssh/sessions/socket_handle.hh"
@@ -30,54 +33,87 @@
 CCCS_BEGIN()
 
 namespace sessions {
+// Forward declaration.
+class agent_cache;
+
 /**
  *  @class session session.hh "com/centreon/connector/ssh/session.hh"
  *  @brief SSH session.
  *
  *  SSH session between Centreon SSH Connector and a remote
- *  host. The session is kept open as long as needed.
+ *  host. The session is kept open as long as needed. Its SFTP
+ *  subsystem channel is opened on first use and shared by the
+ *  built-in checks of the session, one at a time. When password
+ *  authentication fails, identities of the local ssh-agent are tried
+ *  before the key file.
  */
 class session : public com::centreon::handle_listener {
  public:
-  session(credentials const& creds);
+  session(credentials const& creds, agent_cache* agents = nullptr);
   ~session() noexcept override;
   session(session const& s) = delete;
   session& operator=(session const& s) = delete;
+  void add_check() noexcept;
   void close();
   void connect(bool use_ipv6 = false);
   void error();
   void error(handle& h) override;
+  allocator const& get_allocator() const noexcept;
+  unsigned int get_checks_count() const noexcept;
   credentials const& get_credentials() const noexcept;
   LIBSSH2_SESSION* get_libssh2_session() const noexcept;
+  LIBSSH2_SFTP* get_sftp(listener* listnr);
   socket_handle* get_socket_handle() noexcept;
   bool is_connected() const noexcept;
   void listen(listener* listnr);
   LIBSSH2_CHANNEL* new_channel();
   void read(handle& h) override;
+  void release_sftp(listener* listnr);
+  unsigned int remove_check() noexcept;
   void unlisten(listener* listnr);
   bool want_read(handle& h) override;
   bool want_write(handle& h) override;
   void write(handle& h) override;
 
  private:
+  /**
+   *  Order listeners by deadline.
+   */
+  struct by_deadline {
+    bool operator()(listener const* left, listener const* right) const;
+  };
+
   enum e_step {
     session_startup = 0,
     session_password,
+    session_agent,
     session_key,
     session_keepalive,
     session_error
   };
 
+  void _agent();
+  bool _agent_connect();
+  void _agent_disconnect();
   void _available();
   void _key();
   void _passwd();
+  void _shutdown_sftp();
   void _startup();
 
+  LIBSSH2_AGENT* _agent_handle;
+  std::vector<libssh2_agent_publickey*> _agent_identities;
+  size_t _agent_index;
+  agent_cache* _agents;
+  allocator _allocator;
+  unsigned int _checks_count;
   credentials _creds;
-  std::set<listener*> _listnrs;
-  std::set<listener*>::iterator _listnrs_it;
+  std::set<listener*, by_deadline> _listnrs;
+  std::set<listener*, by_deadline>::iterator _listnrs_it;
   bool _needed_new_chan;
   LIBSSH2_SESSION* _session;
+  LIBSSH2_SFTP* _sftp;
+  listener* _sftp_owner;
   socket_handle _socket;
   e_step _step;
   char const* _step_string;
@@ -0,0 +1,61 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#ifndef CCCS_SESSIONS_TOKEN_BUCKET_HH
+#define CCCS_SESSIONS_TOKEN_BUCKET_HH
+
+#include <chrono>
+#include "com/centreon/connector/ssh/namespace.hh"
+
+CCCS_BEGIN()
+
+namespace sessions {
+/**
+ *  @class token_bucket token_bucket.hh
+ * "com/centreon/connector/ssh/sessions/token_bucket.hh"
+ *  @brief Token bucket rate limiter.
+ *
+ *  Bucket refilled at a constant rate (tokens per second) up to a
+ *  maximum capacity. A rate of 0 means that the bucket is unlimited.
+ */
+class token_bucket {
+ public:
+  typedef std::chrono::steady_clock clock;
+
+  token_bucket(unsigned int rate = 0, unsigned int burst = 0);
+  token_bucket(token_bucket const& b) = default;
+  ~token_bucket() = default;
+  token_bucket& operator=(token_bucket const& b) = default;
+  void consume() noexcept;
+  bool is_full(clock::time_point now) noexcept;
+  bool is_limited() const noexcept;
+  std::chrono::milliseconds wait_time(clock::time_point now) noexcept;
+
+ private:
+  void _refill(clock::time_point now) noexcept;
+
+  double _burst;
+  clock::time_point _last;
+  double _rate;
+  double _tokens;
+};
+}  // namespace sessions
+
+CCCS_END()
+
+#endif  // !CCCS_SESSIONS_TOKEN_BUCKET_HH
@@ -0,0 +1,114 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#ifndef CCCS_WORKER_HH
+#define CCCS_WORKER_HH
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include "com/centreon/connector/mpsc_queue.hh"
+#include "com/centreon/connector/ssh/checks/listener.hh"
+#include "com/centreon/connector/ssh/checks/result.hh"
+#include "com/centreon/connector/ssh/namespace.hh"
+#include "com/centreon/connector/ssh/notifier.hh"
+#include "com/centreon/connector/ssh/sessions/credentials.hh"
+#include "com/centreon/timestamp.hh"
+#include "com/centreon/unordered_hash.hh"
+
+CCCS_BEGIN()
+
+// Forward declarations.
+namespace checks {
+class check;
+}
+namespace sessions {
+class agent_cache;
+class connect_queue;
+class handshake_limiter;
+class session;
+}  // namespace sessions
+
+/**
+ *  @class worker worker.hh "com/centreon/connector/ssh/worker.hh"
+ *  @brief Thread running SSH sessions.
+ *
+ *  A worker owns a thread with its own multiplexer. It runs the
+ *  sessions and checks assigned to it and never shares them with
+ *  other threads. Orders are received and results are sent back
+ *  through lock-free queues. A worker whose thread stopped because of
+ *  an error has failed, the connector cannot run its checks anymore.
+ */
+class worker : public checks::listener {
+ public:
+  /**
+   *  Check execution order.
+   */
+  struct order {
+    unsigned long long cmd_id;
+    timestamp timeout;
+    sessions::credentials creds;
+    std::list<std::string> cmds;
+    int skip_stdout;
+    int skip_stderr;
+    bool use_ipv6;
+    bool use_builtin;
+  };
+
+  worker(unsigned int id,
+         sessions::handshake_limiter& limiter,
+         sessions::agent_cache& agents,
+         size_t max_output_size,
+         mpsc_queue<checks::result>& results,
+         notifier& results_notifier);
+  worker(worker const& w) = delete;
+  ~worker() noexcept override;
+  worker& operator=(worker const& w) = delete;
+  void execute(order&& o);
+  bool has_failed() const noexcept;
+  void on_result(checks::result& r) override;
+
+ private:
+  void _cleanup();
+  void _execute(order& o);
+  void _process_orders();
+  void _run();
+
+  sessions::agent_cache& _agents;
+  umap<unsigned long long, std::pair<checks::check*, sessions::session*> >
+      _checks;
+  std::unique_ptr<sessions::connect_queue> _connect_queue;
+  unsigned int _id;
+  sessions::handshake_limiter& _limiter;
+  size_t _max_output_size;
+  notifier _notifier;
+  mpsc_queue<order> _orders;
+  mpsc_queue<checks::result>& _results;
+  notifier& _results_notifier;
+  std::atomic<bool> _failed;
+  umap<sessions::credentials, sessions::session*> _sessions;
+  std::atomic<bool> _should_exit;
+  std::thread _thread;
+};
+
+CCCS_END()
+
+#endif  // !CCCS_WORKER_HH
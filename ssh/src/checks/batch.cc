@@ -0,0 +1,159 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#include "com/centreon/connector/ssh/checks/batch.hh"
+
+#include <sstream>
+
+using namespace com::centreon::connector::ssh::checks;
+
+/**
+ *  Get the severity of a plugin exit code, the higher the worse.
+ *
+ *  @param[in] r Check result.
+ *
+ *  @return 0 for OK, 1 for WARNING, 2 for UNKNOWN and 3 for CRITICAL.
+ */
+static int severity(result const& r) {
+  if (!r.get_executed())
+    return 2;
+  switch (r.get_exit_code()) {
+    case 0:
+      return 0;
+    case 1:
+      return 1;
+    case 2:
+      return 3;
+    default:
+      return 2;
+  }
+}
+
+/**
+ *  Get the first line of a string.
+ *
+ *  @param[in] str String.
+ *
+ *  @return Its first line.
+ */
+static std::string first_line(std::string const& str) {
+  return str.substr(0, str.find('\n'));
+}
+
+/**************************************
+ *                                     *
+ *           Public Methods            *
+ *                                     *
+ **************************************/
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] cmd_id Command ID of the fan-out order.
+ *  @param[in] hosts  Target hosts, in order.
+ */
+batch::batch(unsigned long long cmd_id, std::vector<std::string> const& hosts)
+    : _cmd_id(cmd_id),
+      _hosts(hosts),
+      _received(hosts.size(), false),
+      _remaining(hosts.size()),
+      _results(hosts.size()) {}
+
+/**
+ *  Add the result of one host.
+ *
+ *  @param[in] index Host index.
+ *  @param[in] r     Result of this host.
+ *
+ *  @return true if the host belonged to this batch and its result was
+ *          not already received.
+ */
+bool batch::add(size_t index, result const& r) {
+  if (index >= _hosts.size() || _received[index])
+    return false;
+  _received[index] = true;
+  _results[index] = r;
+  --_remaining;
+  return true;
+}
+
+/**
+ *  Get the command ID of the fan-out order.
+ *
+ *  @return Command ID.
+ */
+unsigned long long batch::get_command_id() const noexcept {
+  return _cmd_id;
+}
+
+/**
+ *  @brief Get the aggregated result.
+ *
+ *  The exit code is the worst of all hosts (CRITICAL, then UNKNOWN,
+ *  then WARNING, then OK), a host that could not run the command
+ *  counts as UNKNOWN. The output starts with a summary line followed
+ *  by the first output line of each host.
+ *
+ *  @return Aggregated result.
+ */
+result batch::get_result() const {
+  static int const exit_codes[] = {0, 1, 3, 2};
+  unsigned int count[4] = {0, 0, 0, 0};
+  int worst(0);
+  std::ostringstream details;
+  std::ostringstream errors;
+  for (size_t i = 0; i < _hosts.size(); ++i) {
+    result const& r(_results[i]);
+    int s(_received[i] ? severity(r) : 2);
+    ++count[s];
+    if (s > worst)
+      worst = s;
+    details << "\n" << _hosts[i] << ": ";
+    if (!_received[i])
+      details << "(no result)";
+    else if (!r.get_executed())
+      details << "(not executed) " << first_line(r.get_error());
+    else
+      details << first_line(r.get_output());
+    if (_received[i] && !r.get_error().empty())
+      errors << (errors.tellp() ? "\n" : "") << _hosts[i] << ": "
+             << first_line(r.get_error());
+  }
+
+  std::ostringstream output;
+  output << _hosts.size() << " hosts: " << count[0] << " OK, " << count[1]
+         << " WARNING, " << count[3] << " CRITICAL, " << count[2]
+         << " UNKNOWN" << details.str();
+
+  result retval;
+  retval.set_command_id(_cmd_id);
+  retval.set_executed(true);
+  retval.set_exit_code(exit_codes[worst]);
+  retval.set_output(output.str());
+  retval.set_error(errors.str());
+  return retval;
+}
+
+/**
+ *  Check whether all hosts reported their result.
+ *
+ *  @return true if the batch is complete.
+ */
+bool batch::is_complete() const noexcept {
+  return !_remaining;
+}
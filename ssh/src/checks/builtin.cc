@@ -0,0 +1,291 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#include "com/centreon/connector/ssh/checks/builtin.hh"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include "com/centreon/exceptions/basic.hh"
+#include "com/centreon/misc/command_line.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::connector::ssh::checks;
+
+namespace {
+/**
+ *  Primitive properties.
+ */
+struct primitive {
+  char const* name;
+  char const* label;
+  char const* perf_label;
+  char const* uom;
+  bool has_field;
+};
+
+// Indexed by builtin::e_type.
+primitive const primitives[] = {{"file-age", "FILE_AGE", "age", "s", false},
+                                {"file-size", "FILE_SIZE", "size", "B", false},
+                                {"proc-file", "PROC_FILE", "value", "", true},
+                                {"regex-count", "REGEX_COUNT", "count", "",
+                                 true}};
+
+char const* const states[] = {"OK", "WARNING", "CRITICAL", "UNKNOWN"};
+
+/**
+ *  Parse a threshold.
+ *
+ *  @param[in]  str   Threshold string.
+ *  @param[out] value Threshold value.
+ */
+void parse_threshold(char const* str, double& value) {
+  char* end(nullptr);
+  value = strtod(str, &end);
+  if (!*str || *end)
+    throw basic_error() << "invalid threshold '" << str << "'";
+}
+}  // namespace
+
+/**************************************
+ *                                     *
+ *           Public Methods            *
+ *                                     *
+ **************************************/
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] cmdline Primitive and its arguments, like
+ *                     "file-age /var/log/messages 300 600".
+ */
+builtin::builtin(std::string const& cmdline)
+    : _critical(0.0), _has_critical(false), _has_warning(false), _warning(0.0) {
+  misc::command_line cmd(cmdline);
+  int ac(cmd.get_argc());
+  char** av(cmd.get_argv());
+  if (ac < 1)
+    throw basic_error() << "empty built-in check";
+
+  // Find primitive.
+  int type(0);
+  int count(sizeof(primitives) / sizeof(*primitives));
+  while (type < count && strcmp(av[0], primitives[type].name))
+    ++type;
+  if (type == count)
+    throw basic_error() << "unknown built-in check '" << av[0] << "'";
+  _type = static_cast<e_type>(type);
+
+  // Arguments.
+  int arg(1);
+  int min_args(primitives[_type].has_field ? 3 : 2);
+  if (ac < min_args || ac > min_args + 2)
+    throw basic_error() << "invalid number of arguments for built-in check '"
+                        << av[0] << "'";
+  _path = av[arg++];
+  if (primitives[_type].has_field) {
+    _field = av[arg++];
+    if (_type == regex_count) {
+      try {
+        _regex = std::regex(_field);
+      } catch (std::regex_error const& e) {
+        throw basic_error() << "invalid regex '" << _field
+                            << "': " << e.what();
+      }
+    }
+  }
+  if (arg < ac) {
+    parse_threshold(av[arg++], _warning);
+    _has_warning = true;
+  }
+  if (arg < ac) {
+    parse_threshold(av[arg++], _critical);
+    _has_critical = true;
+  }
+}
+
+/**
+ *  Evaluate the check from file data.
+ *
+ *  @param[in] size    File size.
+ *  @param[in] mtime   File modification time.
+ *  @param[in] content File content, only fetched if needs_content()
+ *                     returned true.
+ *  @param[in] now     Current time.
+ *
+ *  @return Check result, without command ID.
+ */
+result builtin::evaluate(uint64_t size,
+                         time_t mtime,
+                         std::string const& content,
+                         time_t now) const {
+  double value;
+  try {
+    value = _measure(size, mtime, content, now);
+  } catch (std::exception const& e) {
+    return make_result(3, e.what());
+  }
+
+  int exit_code(0);
+  if (_has_critical && value > _critical)
+    exit_code = 2;
+  else if (_has_warning && value > _warning)
+    exit_code = 1;
+
+  std::ostringstream oss;
+  oss.precision(15);
+  switch (_type) {
+    case file_age:
+      oss << _path << " is " << value << " s old";
+      break;
+    case file_size:
+      oss << _path << " is " << value << " bytes";
+      break;
+    case proc_file:
+      oss << _field << " of " << _path << " is " << value;
+      break;
+    case regex_count:
+      oss << value << " lines of " << _path << " match '" << _field << "'";
+      break;
+  }
+  oss << "|" << primitives[_type].perf_label << "=" << value
+      << primitives[_type].uom << ";";
+  if (_has_warning)
+    oss << _warning;
+  oss << ";";
+  if (_has_critical)
+    oss << _critical;
+  return make_result(exit_code, oss.str());
+}
+
+/**
+ *  Get the path of the file to check.
+ *
+ *  @return Remote file path.
+ */
+std::string const& builtin::get_path() const noexcept {
+  return _path;
+}
+
+/**
+ *  Get the primitive type.
+ *
+ *  @return Primitive type.
+ */
+builtin::e_type builtin::get_type() const noexcept {
+  return _type;
+}
+
+/**
+ *  Build a check result, without command ID.
+ *
+ *  @param[in] exit_code Plugin exit code.
+ *  @param[in] message   Output, without the status prefix.
+ *
+ *  @return Check result.
+ */
+result builtin::make_result(int exit_code,
+                            std::string const& message) const {
+  result r;
+  r.set_executed(true);
+  r.set_exit_code(exit_code);
+  r.set_output(std::string(primitives[_type].label) + " " + states[exit_code] +
+               " - " + message);
+  return r;
+}
+
+/**
+ *  Check whether the file content is needed, otherwise its attributes
+ *  are enough.
+ *
+ *  @return true if the file must be read.
+ */
+bool builtin::needs_content() const noexcept {
+  return _type == proc_file || _type == regex_count;
+}
+
+/**************************************
+ *                                     *
+ *           Private Methods           *
+ *                                     *
+ **************************************/
+
+/**
+ *  Measure the checked value.
+ *
+ *  @param[in] size    File size.
+ *  @param[in] mtime   File modification time.
+ *  @param[in] content File content.
+ *  @param[in] now     Current time.
+ *
+ *  @return Measured value.
+ */
+double builtin::_measure(uint64_t size,
+                         time_t mtime,
+                         std::string const& content,
+                         time_t now) const {
+  switch (_type) {
+    case file_age:
+      return now > mtime ? now - mtime : 0;
+    case file_size:
+      return size;
+    case proc_file: {
+      std::istringstream iss(content);
+      char* end(nullptr);
+      unsigned long index(strtoul(_field.c_str(), &end, 10));
+      if (!*end && index) {
+        // N-th token.
+        std::string token;
+        for (unsigned long i = 0; i < index; ++i)
+          if (!(iss >> token))
+            throw basic_error() << _path << " has less than " << index
+                                << " fields";
+        double value(strtod(token.c_str(), &end));
+        if (end == token.c_str())
+          throw basic_error() << "field " << index << " of " << _path
+                              << " is not a number";
+        return value;
+      }
+      // Named line.
+      std::string line;
+      while (std::getline(iss, line))
+        if (!line.compare(0, _field.size(), _field) &&
+            (line.size() > _field.size()) &&
+            (line[_field.size()] == ':' || isspace(line[_field.size()]))) {
+          char const* ptr(line.c_str() + _field.size() + 1);
+          double value(strtod(ptr, &end));
+          if (end == ptr)
+            throw basic_error() << _field << " of " << _path
+                                << " is not a number";
+          return value;
+        }
+      throw basic_error() << _field << " was not found in " << _path;
+    }
+    case regex_count: {
+      std::istringstream iss(content);
+      std::string line;
+      unsigned int count(0);
+      while (std::getline(iss, line))
+        if (std::regex_search(line, _regex))
+          ++count;
+      return count;
+    }
+  }
+  return 0;
+}
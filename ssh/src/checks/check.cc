@@ -20,14 +20,17 @@
 
 #include <cstdio>
 #include <memory>
+#include <utility>
 
 #include "com/centreon/connector/log.hh"
-#include "com/centreon/connector/ssh/checks/timeout.hh"
 #include "com/centreon/connector/ssh/multiplexer.hh"
 #include "com/centreon/exceptions/basic.hh"
 
 using namespace com::centreon::connector::ssh::checks;
 
+// Largest file read by built-in checks.
+static size_t const max_file_size = 16 * 1024 * 1024;
+
 /**************************************
  *                                     *
  *           Public Methods            *
@@ -37,18 +40,29 @@ using namespace com::centreon::connector::ssh::checks;
 /**
  *  Default constructor.
  *
- *  @param[in] skip_stdout Ignore all or first n output lines.
- *  @param[in] skip_stderr Ignore all or first n error lines.
+ *  @param[in] skip_stdout     Ignore all or first n output lines.
+ *  @param[in] skip_stderr     Ignore all or first n error lines.
+ *  @param[in] max_output_size Maximum size of each output stream, 0
+ *                             for no limit.
+ *  @param[in] use_builtin     Commands are built-in checks.
  */
-check::check(int skip_stdout, int skip_stderr)
+check::check(int skip_stdout,
+             int skip_stderr,
+             size_t max_output_size,
+             bool use_builtin)
     : _channel(nullptr),
       _cmd_id(0),
+      _file(nullptr),
+      _file_mtime(0),
+      _file_size(0),
       _listnr(nullptr),
       _session(nullptr),
       _skip_stderr(skip_stderr),
-      _skip_stdout(skip_stdout),
+      _stderr(skip_stderr, max_output_size),
+      _stdout(skip_stdout, max_output_size),
       _step(chan_open),
-      _timeout(0) {}
+      _timeout(this),
+      _use_builtin(use_builtin) {}
 
 /**
  *  Destructor.
@@ -97,14 +111,25 @@ void check::execute(sessions::session& sess,
   // Log message.
   log::core()->debug("check {0} has ID {1}", static_cast<void*>(this), cmd_id);
 
+  // Built-in checks are parsed upfront.
+  if (_use_builtin) {
+    if (cmds.size() != 1)
+      throw basic_error() << "built-in checks accept a single command";
+    _builtin.reset(new builtin(cmds.front()));
+    _step = sftp_stat;
+  }
+
   // Store command information.
   _cmds = cmds;
   _cmd_id = cmd_id;
+  _deadline = tmt;
   _session = &sess;
 
-  // Register timeout.
-  _timeout = multiplexer::instance().com::centreon::task_manager::add(
-      new timeout(this), tmt, false, true);
+  // Register timeout. The deadline is converted once to the monotonic
+  // clock so that system time changes do not affect it.
+  long long remaining(tmt.to_mseconds() - timestamp::now().to_mseconds());
+  multiplexer::instance().timer_wheel::add(
+      _timeout, timer_wheel::now() + (remaining > 0 ? remaining : 0));
 
   // Session-related actions.
   sess.listen(this);
@@ -112,6 +137,15 @@ void check::execute(sessions::session& sess,
     on_connected(sess);
 }
 
+/**
+ *  Get the deadline of the check, sessions serve earliest ones first.
+ *
+ *  @return Check deadline.
+ */
+com::centreon::timestamp const& check::get_deadline() const noexcept {
+  return _deadline;
+}
+
 /**
  *  Listen the check.
  *
@@ -164,6 +198,15 @@ void check::on_available(sessions::session& sess) {
           log::core()->info("channel of check {} successfully closed", _cmd_id);
         }
       } break;
+      case sftp_stat:
+      case sftp_open:
+      case sftp_read:
+      case sftp_close: {
+        unsigned long long cmd_id(_cmd_id);
+        log::core()->info("running built-in check {}", cmd_id);
+        if (!_sftp())
+          log::core()->info("built-in check {} was successfully run", cmd_id);
+      } break;
       default:
         throw basic_error() << "channel requested to run at invalid step";
     }
@@ -215,9 +258,6 @@ void check::on_timeout() {
   // Log message.
   log::core()->warn("check {} reached timeout", _cmd_id);
 
-  // Reset timeout task ID.
-  _timeout = 0;
-
   // Send check result.
   result r;
   r.set_command_id(_cmd_id);
@@ -276,19 +316,16 @@ bool check::_close() {
       // Method should not be called again.
       retval = false;
 
-      if (_skip_stdout != -1)
-        _skip_data(_stdout, _skip_stdout);
-      if (_skip_stderr != -1)
-        _skip_data(_stderr, _skip_stderr);
-
       // Send results to parent process.
       if (_cmds.empty()) {
+        if (_stdout.is_truncated() || _stderr.is_truncated())
+          log::core()->warn("output of check {} was truncated", _cmd_id);
         result r;
         r.set_command_id(_cmd_id);
-        r.set_error(_stderr);
+        r.set_error(_stderr.release());
         r.set_executed(true);
         r.set_exit_code(exitcode);
-        r.set_output(_stdout);
+        r.set_output(_stdout.release());
         _send_result_and_unregister(r);
       } else {
         _step = chan_open;
@@ -310,6 +347,15 @@ bool check::_close() {
  *  @return true while the command was not successfully executed.
  */
 bool check::_exec() {
+  // Error output is not wanted at all, let libssh2 discard it as soon
+  // as it is received instead of buffering it.
+  if (!_skip_stderr) {
+    int ret(libssh2_channel_handle_extended_data2(
+        _channel, LIBSSH2_CHANNEL_EXTENDED_DATA_IGNORE));
+    if (ret == LIBSSH2_ERROR_EAGAIN)
+      return true;
+  }
+
   // Attempt to execute command.
   int ret(libssh2_channel_exec(_channel, _cmds.front().c_str()));
 
@@ -371,8 +417,10 @@ bool check::_read() {
   else
     _stdout.append(buffer, orb);
 
-  // Read command's stderr.
-  int erb(libssh2_channel_read_ex(_channel, 1, buffer, sizeof(buffer)));
+  // Read command's stderr, unless libssh2 already discards it.
+  int erb(_skip_stderr
+              ? libssh2_channel_read_ex(_channel, 1, buffer, sizeof(buffer))
+              : LIBSSH2_ERROR_EAGAIN);
   if (erb > 0)
     _stderr.append(buffer, erb);
 
@@ -383,20 +431,109 @@ bool check::_read() {
 }
 
 /**
- *  Send check result and unregister from session.
+ *  Run built-in check steps on the SFTP subsystem of the session.
  *
- *  @param[in] r Check result.
+ *  @return true while the built-in check did not complete.
  */
-void check::_send_result_and_unregister(result const& r) {
-  // Remove timeout task.
-  if (_timeout) {
-    try {
-      multiplexer::instance().com::centreon::task_manager::remove(_timeout);
-    } catch (...) {
+bool check::_sftp() {
+  LIBSSH2_SFTP* sftp(_session->get_sftp(this));
+  if (!sftp)
+    return true;
+
+  std::string const& path(_builtin->get_path());
+  switch (_step) {
+    case sftp_stat: {
+      LIBSSH2_SFTP_ATTRIBUTES attrs;
+      int ret(libssh2_sftp_stat(sftp, path.c_str(), &attrs));
+      if (ret == LIBSSH2_ERROR_EAGAIN)
+        return true;
+      if (ret) {
+        if (ret != LIBSSH2_ERROR_SFTP_PROTOCOL ||
+            libssh2_sftp_last_error(sftp) != LIBSSH2_FX_NO_SUCH_FILE) {
+          if (ret == LIBSSH2_ERROR_SOCKET_SEND)
+            _session->error();
+          _session->release_sftp(this);
+          throw basic_error() << "could not stat '" << path
+                              << "' (error " << ret << ")";
+        }
+        _session->release_sftp(this);
+        result r(_builtin->make_result(2, path + " does not exist"));
+        r.set_command_id(_cmd_id);
+        _send_result_and_unregister(r);
+        return false;
+      }
+      _file_size = attrs.filesize;
+      _file_mtime = attrs.mtime;
+      if (!_builtin->needs_content())
+        break;
+      _step = sftp_open;
     }
-    _timeout = 0;
+    // Fall through.
+    case sftp_open:
+      _file = libssh2_sftp_open(sftp, path.c_str(), LIBSSH2_FXF_READ, 0);
+      if (!_file) {
+        char* msg;
+        int ret(libssh2_session_last_error(_session->get_libssh2_session(),
+                                           &msg, nullptr, 0));
+        if (ret == LIBSSH2_ERROR_EAGAIN)
+          return true;
+        if (ret == LIBSSH2_ERROR_SOCKET_SEND)
+          _session->error();
+        _session->release_sftp(this);
+        throw basic_error() << "could not open '" << path << "': " << msg;
+      }
+      _step = sftp_read;
+      // Fall through.
+    case sftp_read:
+      while (_content.size() <= max_file_size) {
+        char buffer[16384];
+        ssize_t rb(libssh2_sftp_read(_file, buffer, sizeof(buffer)));
+        if (rb == LIBSSH2_ERROR_EAGAIN)
+          return true;
+        if (rb < 0) {
+          if (rb == LIBSSH2_ERROR_SOCKET_SEND)
+            _session->error();
+          throw basic_error() << "could not read '" << path << "' (error "
+                              << rb << ")";
+        }
+        if (!rb)
+          break;
+        _content.append(buffer, rb);
+      }
+      _step = sftp_close;
+      // Fall through.
+    case sftp_close: {
+      int ret(libssh2_sftp_close_handle(_file));
+      if (ret == LIBSSH2_ERROR_EAGAIN)
+        return true;
+      _file = nullptr;
+    } break;
+    default:
+      throw basic_error() << "SFTP requested to run at invalid step";
   }
 
+  // Evaluate the check. File age is computed with the local clock.
+  _session->release_sftp(this);
+  result r(_content.size() > max_file_size
+               ? _builtin->make_result(
+                     3, path + " is larger than " +
+                            std::to_string(max_file_size) + " bytes")
+               : _builtin->evaluate(_file_size, _file_mtime, _content,
+                                    time(nullptr)));
+  r.set_command_id(_cmd_id);
+  _send_result_and_unregister(r);
+  return false;
+}
+
+/**
+ *  Send check result and unregister from session.
+ *
+ *  @param[in] r Check result.
+ */
+void check::_send_result_and_unregister(result& r) {
+  // Disarm timeout.
+  _timeout.cancel();
+
   // Check that session is valid.
   if (_session) {
     // Unregister from session.
@@ -418,26 +555,3 @@ void check::_send_result_and_unregister(result const& r) {
       _listnr->on_result(r);
   }
 }
-
-/**
- *  Skip n lines.
- *
- *  @param[in] data    The string to truncate.
- *  @param[in] nb_line The number of lines to keep.
- *
- *  @return The first argument.
- */
-std::string& check::_skip_data(std::string& data, int nb_line) {
-  if (nb_line < 0)
-    return data;
-  if (!nb_line)
-    data.clear();
-  else {
-    size_t pos(0);
-    for (int i(0); i < nb_line && pos != std::string::npos; ++i)
-      pos = data.find("\n", pos + 1);
-    if (pos != std::string::npos)
-      data.resize(pos);
-  }
-  return data;
-}
@@ -0,0 +1,127 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#include "com/centreon/connector/ssh/checks/output_filter.hh"
+
+#include <cstring>
+#include <utility>
+
+using namespace com::centreon::connector::ssh::checks;
+
+// Appended to data truncated because of the size limit.
+static char const truncation_marker[] = "\n(output truncated)";
+
+/**************************************
+ *                                     *
+ *           Public Methods            *
+ *                                     *
+ **************************************/
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] max_lines Number of lines to keep, -1 to keep them all.
+ *  @param[in] max_size  Maximum number of bytes to keep, 0 for no
+ *                       limit.
+ */
+output_filter::output_filter(int max_lines, size_t max_size)
+    : _full(!max_lines),
+      _lines_left(max_lines),
+      _max_size(max_size),
+      _received(0),
+      _truncated(false) {}
+
+/**
+ *  Append data read from the stream.
+ *
+ *  @param[in] data Data.
+ *  @param[in] size Data size.
+ */
+void output_filter::append(char const* data, size_t size) {
+  size_t offset(_received);
+  _received += size;
+  if (_full)
+    return;
+
+  // Look for the end of the last kept line. The newline character is
+  // not part of the kept data. For compatibility with older versions,
+  // a newline starting the stream does not count as a line.
+  size_t keep(size);
+  if (_lines_left > 0) {
+    char const* end(data + size);
+    for (char const* it(data); it < end; ++it) {
+      it = static_cast<char const*>(memchr(it, '\n', end - it));
+      if (!it)
+        break;
+      if ((offset || it != data) && !--_lines_left) {
+        keep = it - data;
+        _full = true;
+        break;
+      }
+    }
+  }
+
+  // Apply size limit.
+  if (_max_size && _data.size() + keep > _max_size) {
+    keep = _max_size - _data.size();
+    _full = true;
+    _truncated = true;
+  }
+  _data.append(data, keep);
+}
+
+/**
+ *  Get the data kept so far.
+ *
+ *  @return Kept data.
+ */
+std::string const& output_filter::get_data() const noexcept {
+  return _data;
+}
+
+/**
+ *  Check if filter drops all new data.
+ *
+ *  @return true if no more data will be kept.
+ */
+bool output_filter::is_full() const noexcept {
+  return _full;
+}
+
+/**
+ *  Check if data was truncated because of the size limit.
+ *
+ *  @return true if data was truncated.
+ */
+bool output_filter::is_truncated() const noexcept {
+  return _truncated;
+}
+
+/**
+ *  Extract kept data. The filter is empty afterwards. If the size
+ *  limit was reached, a marker is appended to the returned data.
+ *
+ *  @return Kept data.
+ */
+std::string output_filter::release() {
+  if (_truncated)
+    _data.append(truncation_marker, sizeof(truncation_marker) - 1);
+  std::string retval(std::move(_data));
+  _data.clear();
+  return retval;
+}
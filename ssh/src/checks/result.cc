@@ -18,6 +18,8 @@
 
 #include "com/centreon/connector/ssh/checks/result.hh"
 
+#include <utility>
+
 using namespace com::centreon::connector::ssh::checks;
 
 /**************************************
@@ -53,6 +55,22 @@ result& result::operator=(result const& r) {
   return (*this);
 }
 
+/**
+ *  Move constructor.
+ *
+ *  @param[in] r Object to move.
+ */
+result::result(result&& r) noexcept = default;
+
+/**
+ *  Move assignment operator.
+ *
+ *  @param[in] r Object to move.
+ *
+ *  @return This object.
+ */
+result& result::operator=(result&& r) noexcept = default;
+
 /**
  *  Get the command ID.
  *
@@ -116,6 +134,15 @@ void result::set_error(std::string const& error) {
   _error = error;
 }
 
+/**
+ *  Set the error string.
+ *
+ *  @param[in] error Error string, moved into the result.
+ */
+void result::set_error(std::string&& error) noexcept {
+  _error = std::move(error);
+}
+
 /**
  *  Set the executed flag.
  *
@@ -144,6 +171,15 @@ void result::set_output(std::string const& output) {
   _output = output;
 }
 
+/**
+ *  Set the check output.
+ *
+ *  @param[in] output Check output, moved into the result.
+ */
+void result::set_output(std::string&& output) noexcept {
+  _output = std::move(output);
+}
+
 /**************************************
  *                                     *
  *           Private Methods           *
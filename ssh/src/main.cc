@@ -137,7 +137,7 @@ int main(int argc, char* argv[]) {
       signal(SIGTERM, term_handler);
 
       // Program policy.
-      policy p;
+      policy p(opts);
       retval = (p.run() ? EXIT_SUCCESS : EXIT_FAILURE);
     }
   } catch (std::exception const& e) {
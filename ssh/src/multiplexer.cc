@@ -21,8 +21,8 @@
 
 using namespace com::centreon::connector::ssh;
 
-// Class instance pointer.
-static multiplexer* _instance = nullptr;
+// Class instance pointer of the current thread.
+static thread_local multiplexer* _instance = nullptr;
 
 /**************************************
  *                                     *
@@ -41,7 +41,7 @@ multiplexer& multiplexer::instance() noexcept {
 }
 
 /**
- * Load singleton.
+ * Load singleton of the current thread.
  */
 void multiplexer::load() {
   if (!_instance)
@@ -49,7 +49,7 @@ void multiplexer::load() {
 }
 
 /**
- * Unload singleton.
+ * Unload singleton of the current thread.
  */
 void multiplexer::unload() {
   delete _instance;
@@ -65,4 +65,4 @@ void multiplexer::unload() {
 /**
  *  Default constructor.
  */
-multiplexer::multiplexer() : com::centreon::handle_manager(this) {}
+multiplexer::multiplexer() : com::centreon::connector::reactor(this, this) {}
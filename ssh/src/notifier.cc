@@ -0,0 +1,170 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#include "com/centreon/connector/ssh/notifier.hh"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "com/centreon/connector/log.hh"
+#include "com/centreon/exceptions/basic.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::connector;
+using namespace com::centreon::connector::ssh;
+
+/**************************************
+ *                                     *
+ *           Public Methods            *
+ *                                     *
+ **************************************/
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] callback Called when the notifier was notified.
+ */
+notifier::notifier(std::function<void()> callback)
+    : _callback(std::move(callback)) {
+  _fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (_fd < 0) {
+    char const* msg(strerror(errno));
+    throw basic_error() << "could not create event descriptor: " << msg;
+  }
+}
+
+/**
+ *  Destructor.
+ */
+notifier::~notifier() noexcept {
+  this->close();
+}
+
+/**
+ *  Close event descriptor.
+ */
+void notifier::close() {
+  if (_fd != native_handle_null) {
+    ::close(_fd);
+    _fd = native_handle_null;
+  }
+}
+
+/**
+ *  Error occurred on the event descriptor.
+ *
+ *  @param[in] h Unused.
+ */
+void notifier::error([[maybe_unused]] handle& h) {
+  log::core()->error("error detected on event descriptor {}", _fd);
+}
+
+/**
+ *  Get the native event descriptor.
+ *
+ *  @return Event descriptor.
+ */
+native_handle notifier::get_native_handle() {
+  return _fd;
+}
+
+/**
+ *  Wake up the thread multiplexing this notifier. Can be called from
+ *  any thread.
+ */
+void notifier::notify() {
+  uint64_t value(1);
+  write(&value, sizeof(value));
+}
+
+/**
+ *  Read and reset the event counter.
+ *
+ *  @param[out] data Where counter is stored.
+ *  @param[in]  size Buffer size, must be at least 8 bytes.
+ *
+ *  @return Number of bytes read, 0 if counter was not set.
+ */
+unsigned long notifier::read(void* data, unsigned long size) {
+  ssize_t rb(::read(_fd, data, size));
+  if (rb < 0) {
+    if (errno == EAGAIN)
+      return 0;
+    char const* msg(strerror(errno));
+    throw basic_error() << "event descriptor read error: " << msg;
+  }
+  return rb;
+}
+
+/**
+ *  Notification received, run callback.
+ *
+ *  @param[in] h Unused.
+ */
+void notifier::read([[maybe_unused]] handle& h) {
+  uint64_t value;
+  read(&value, sizeof(value));
+  _callback();
+}
+
+/**
+ *  Notifier always wants to be woken up.
+ *
+ *  @param[in] h Unused.
+ *
+ *  @return true.
+ */
+bool notifier::want_read([[maybe_unused]] handle& h) {
+  return true;
+}
+
+/**
+ *  Notifier is never written by the multiplexer.
+ *
+ *  @param[in] h Unused.
+ *
+ *  @return false.
+ */
+bool notifier::want_write([[maybe_unused]] handle& h) {
+  return false;
+}
+
+/**
+ *  Increment the event counter.
+ *
+ *  @param[in] data Counter increment.
+ *  @param[in] size Must be 8 bytes.
+ *
+ *  @return Number of bytes written.
+ */
+unsigned long notifier::write(void const* data, unsigned long size) {
+  ssize_t wb(::write(_fd, data, size));
+  if (wb < 0) {
+    // Counter is saturated, a notification is already pending.
+    if (errno == EAGAIN)
+      return 0;
+    char const* msg(strerror(errno));
+    throw basic_error() << "event descriptor write error: " << msg;
+  }
+  return wb;
+}
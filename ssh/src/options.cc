@@ -17,12 +17,18 @@
 */
 
 #include "com/centreon/connector/ssh/orders/options.hh"
+#include <cstdlib>
+#include <limits>
 #include <sstream>
 #include "com/centreon/connector/ssh/options.hh"
+#include "com/centreon/exceptions/basic.hh"
 
 using namespace com::centreon::connector::ssh;
 
 // Options descriptions.
+static char const* const compress_description =
+    "Compress the SSH transport of all checks, useful on low bandwidth "
+    "links (default: only checks run with --compress).";
 static char const* const debug_description =
     "If this flag is specified, print all logs messages.";
 static char const* const help_description = "Print help and exit.";
@@ -30,6 +36,17 @@ static char const* const version_description =
     "Print software version and exit.";
 static char const* const log_file_description =
     "Specifies the log file (default: stderr).";
+static char const* const max_handshakes_description =
+    "Maximum number of new SSH handshakes per second (default: 0, "
+    "unlimited).";
+static char const* const max_output_size_description =
+    "Maximum number of bytes kept from each output stream of a check, "
+    "output is truncated beyond (default: 0, unlimited).";
+static char const* const threads_description =
+    "Number of worker threads running SSH sessions (default: 1).";
+static char const* const max_host_handshakes_description =
+    "Maximum number of new SSH handshakes per second toward a single "
+    "host (default: 0, unlimited).";
 
 /**************************************
  *                                     *
@@ -71,16 +88,45 @@ options& options::operator=(options const& opts) {
   return *this;
 }
 
+/**
+ *  Get the value of a numeric argument.
+ *
+ *  @param[in] long_name     Argument long name.
+ *  @param[in] default_value Value returned if argument is not set.
+ *
+ *  @return Argument value.
+ */
+unsigned int options::get_unsigned(std::string const& long_name,
+                                   unsigned int default_value) const {
+  misc::argument const& arg(get_argument(long_name));
+  if (!arg.get_is_set())
+    return default_value;
+  std::string const& value(arg.get_value());
+  char* end(nullptr);
+  unsigned long retval(strtoul(value.c_str(), &end, 10));
+  if (value.empty() || *end || value[0] == '-' ||
+      retval > std::numeric_limits<unsigned int>::max())
+    throw basic_error() << "invalid value '" << value << "' for argument '"
+                        << long_name << "'";
+  return retval;
+}
+
 /**
  *  Get the help.
  */
 std::string options::help() const {
   std::ostringstream oss;
   oss << "centreon_connector_ssh [args]\n"
+      << "  --compress " << compress_description << "\n"
       << "  --debug    " << debug_description << "\n"
       << "  --help     " << help_description << "\n"
       << "  --version  " << version_description << "\n"
       << "  --log-file " << log_file_description << "\n"
+      << "  --max-handshakes      " << max_handshakes_description << "\n"
+      << "  --max-host-handshakes " << max_host_handshakes_description
+      << "\n"
+      << "  --max-output-size     " << max_output_size_description << "\n"
+      << "  --threads             " << threads_description << "\n"
       << "\n"
       << "Commands must be sent on the connector's standard input.\n"
       << "They must be sent using Centreon Connector protocol version\n"
@@ -101,6 +147,12 @@ std::string options::help() const {
  */
 void options::parse(int argc, char* argv[]) {
   _parse_arguments(argc, argv);
+
+  // Validate numeric arguments.
+  get_unsigned("max-handshakes");
+  get_unsigned("max-host-handshakes");
+  get_unsigned("max-output-size");
+  get_unsigned("threads");
 }
 
 /**
@@ -120,6 +172,14 @@ std::string options::usage() const {
  *  Init argument table.
  */
 void options::_init() {
+  // Compression.
+  {
+    misc::argument& arg(_arguments['z']);
+    arg.set_name('z');
+    arg.set_long_name("compress");
+    arg.set_description(compress_description);
+  }
+
   // Debug.
   {
     misc::argument& arg(_arguments['d']);
@@ -152,4 +212,40 @@ void options::_init() {
     arg.set_description(log_file_description);
     arg.set_has_value(true);
   }
+
+  // Handshake rate.
+  {
+    misc::argument& arg(_arguments['m']);
+    arg.set_name('m');
+    arg.set_long_name("max-handshakes");
+    arg.set_description(max_handshakes_description);
+    arg.set_has_value(true);
+  }
+
+  // Handshake rate per host.
+  {
+    misc::argument& arg(_arguments['M']);
+    arg.set_name('M');
+    arg.set_long_name("max-host-handshakes");
+    arg.set_description(max_host_handshakes_description);
+    arg.set_has_value(true);
+  }
+
+  // Output size.
+  {
+    misc::argument& arg(_arguments['s']);
+    arg.set_name('s');
+    arg.set_long_name("max-output-size");
+    arg.set_description(max_output_size_description);
+    arg.set_has_value(true);
+  }
+
+  // Worker threads.
+  {
+    misc::argument& arg(_arguments['t']);
+    arg.set_name('t');
+    arg.set_long_name("threads");
+    arg.set_description(threads_description);
+    arg.set_has_value(true);
+  }
 }
@@ -35,7 +35,9 @@ using namespace com::centreon::connector::ssh::orders;
 static char const* optstr = "1246a:C:E:fhH:i:l:n:o:O:p:qs:S:t:vV";
 static struct option optlong[] = {
     {"authentication", required_argument, nullptr, 'a'},
+    {"builtin", no_argument, nullptr, 'b'},
     {"command", required_argument, nullptr, 'C'},
+    {"compress", no_argument, nullptr, 'z'},
     {"fork", no_argument, nullptr, 'f'},
     {"help", no_argument, nullptr, 'h'},
     {"hostname", required_argument, nullptr, 'H'},
@@ -69,7 +71,9 @@ static struct option optlong[] = {
  *  Default constructor.
  */
 options::options(std::string const& cmdline)
-    : _ip_protocol(ip_v4),
+    : _builtin(false),
+      _compress(false),
+      _ip_protocol(ip_v4),
       _port(22),
       _skip_stderr(-1),
       _skip_stdout(-1),
@@ -87,6 +91,15 @@ std::string const& options::get_authentication() const noexcept {
   return (_authentication);
 }
 
+/**
+ *  Check whether commands are built-in checks.
+ *
+ *  @return true if commands are run over SFTP by the connector.
+ */
+bool options::get_builtin() const noexcept {
+  return (_builtin);
+}
+
 /**
  *  Get command to execute on the remote machine.
  *
@@ -96,6 +109,15 @@ std::list<std::string> const& options::get_commands() const noexcept {
   return (_commands);
 }
 
+/**
+ *  Check whether transport compression was requested.
+ *
+ *  @return true if the SSH session must be compressed.
+ */
+bool options::get_compress() const noexcept {
+  return (_compress);
+}
+
 /**
  *  Get host name, IP Address.
  *
@@ -163,7 +185,11 @@ std::string options::help() {
       "  -4, --use-ipv4:       Enable IPv4 connection.\n"
       "  -6, --use-ipv6:       Enable IPv6 connection.\n"
       "  -a, --authentication: Authentication password.\n"
+      "      --builtin:        Commands are built-in checks run over SFTP\n"
+      "                        (file-age, file-size, proc-file,\n"
+      "                        regex-count).\n"
       "  -C, --command:        Command to execute on the remote machine.\n"
+      "      --compress:       Compress the SSH transport.\n"
       "  -E, --skip-stderr:    Ignore all or first n lines on STDERR.\n"
       "  -f, --fork:           This option is not supported.\n"
       "  -h, --help:           Not used.\n"
@@ -208,6 +234,14 @@ void options::parse(std::string const& cmdline) {
         _commands.emplace_back(optarg);
         break;
 
+      case 'b':  // Built-in checks (long option only).
+        _builtin = true;
+        break;
+
+      case 'z':  // Enable compression (long option only, -C is taken).
+        _compress = true;
+        break;
+
       case 'a':  // Set user.
         _authentication = optarg;
         break;
@@ -20,6 +20,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <string>
+#include <vector>
 #include "com/centreon/connector/log.hh"
 #include "com/centreon/connector/ssh/orders/options.hh"
 #include "com/centreon/exceptions/basic.hh"
@@ -82,7 +83,7 @@ void parser::listen(listener* l) noexcept {
 void parser::read(handle& h) {
   // Read data.
   log::core()->debug("reading data for parsing");
-  char buffer[4096];
+  char buffer[65536];
   unsigned long rb(h.read(buffer, sizeof(buffer)));
   log::core()->debug("read {} bytes from handle", rb);
 
@@ -174,6 +175,7 @@ void parser::_parse(std::string const& cmd) {
         _listnr->on_version();
       break;
     case 2:  // Execute query.
+    case 6:  // Fan-out execute query.
     {
       // Note: no need to check npos because cmd is
       //       terminated with at least 4 \0.
@@ -182,7 +184,7 @@ void parser::_parse(std::string const& cmd) {
       size_t end(cmd.find('\0', pos));
       char* ptr(nullptr);
       unsigned long long cmd_id(strtoull(cmd.c_str() + pos, &ptr, 10));
-      if (!cmd_id || *ptr)
+      if (!cmd_id || *ptr || cmd_id >= first_reserved_id)
         throw basic_error() << "invalid execution request received:"
                                " bad command ID ("
                             << cmd.c_str() + pos << ")";
@@ -191,13 +193,10 @@ void parser::_parse(std::string const& cmd) {
       end = cmd.find('\0', pos);
       time_t timeout(
           static_cast<time_t>(strtoull(cmd.c_str() + pos, &ptr, 10)));
-      timestamp ts_timeout = timestamp::now();
-
       if (*ptr)
         throw basic_error() << "invalid execution request received:"
                                " bad timeout ("
                             << cmd.c_str() + pos << ")";
-      ts_timeout += timeout;
       pos = end + 1;
       // Find start time.
       end = cmd.find('\0', pos);
@@ -208,6 +207,31 @@ void parser::_parse(std::string const& cmd) {
                                " bad start time ("
                             << cmd.c_str() + pos << ")";
       pos = end + 1;
+      // The deadline runs from the time the monitoring engine started
+      // the check, the order might have waited before reaching us. A
+      // start time in the future (clock skew) is ignored.
+      timestamp ts_start(timestamp::now());
+      if (timestamp(start_time) < ts_start)
+        ts_start = timestamp(start_time);
+      timestamp ts_timeout(ts_start + timeout);
+      // Fan-out orders carry a host list.
+      std::vector<std::string> hosts;
+      if (id == 6) {
+        end = cmd.find('\0', pos);
+        for (size_t first(pos); first < end;) {
+          size_t last(cmd.find(',', first));
+          if (last == std::string::npos || last > end)
+            last = end;
+          if (last > first)
+            hosts.emplace_back(cmd.substr(first, last - first));
+          first = last + 1;
+        }
+        if (hosts.empty())
+          throw basic_error() << "invalid execution request received:"
+                                 " bad host list ("
+                              << cmd.substr(pos, end - pos) << ")";
+        pos = end + 1;
+      }
       // Find command to execute.
       end = cmd.find('\0', pos);
       std::string cmdline(cmd.substr(pos, end - pos));
@@ -225,7 +249,7 @@ void parser::_parse(std::string const& cmd) {
 
         if (opt.get_timeout() &&
             opt.get_timeout() < static_cast<unsigned int>(timeout))
-          ts_timeout = timestamp::now() + opt.get_timeout();
+          ts_timeout = ts_start + opt.get_timeout();
         else if (opt.get_timeout() > static_cast<unsigned int>(timeout))
           throw basic_error()
                 << "invalid execution request "
@@ -237,12 +261,22 @@ void parser::_parse(std::string const& cmd) {
       }
 
       // Notify listener.
-      if (_listnr)
-        _listnr->on_execute(cmd_id, ts_timeout, opt.get_host(), opt.get_port(),
-                            opt.get_user(), opt.get_authentication(),
-                            opt.get_identity_file(), opt.get_commands(),
-                            opt.skip_stdout(), opt.skip_stderr(),
-                            (opt.get_ip_protocol() == options::ip_v6));
+      if (_listnr) {
+        if (id == 6)
+          _listnr->on_execute_many(
+              cmd_id, ts_timeout, hosts, opt.get_port(),
+              opt.get_user(), opt.get_authentication(),
+              opt.get_identity_file(), opt.get_commands(), opt.skip_stdout(),
+              opt.skip_stderr(), (opt.get_ip_protocol() == options::ip_v6),
+              opt.get_compress(), opt.get_builtin());
+        else
+          _listnr->on_execute(
+              cmd_id, ts_timeout, opt.get_host(), opt.get_port(),
+              opt.get_user(), opt.get_authentication(),
+              opt.get_identity_file(), opt.get_commands(), opt.skip_stdout(),
+              opt.skip_stderr(), (opt.get_ip_protocol() == options::ip_v6),
+              opt.get_compress(), opt.get_builtin());
+      }
     } break;
     case 4:  // Quit query.
       if (_listnr)
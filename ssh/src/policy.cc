@@ -20,14 +20,12 @@
 
 #include <atomic>
 #include <cstdio>
-#include <memory>
+#include <cstdlib>
 
 #include "com/centreon/connector/log.hh"
-#include "com/centreon/connector/ssh/checks/check.hh"
-#include "com/centreon/connector/ssh/checks/result.hh"
 #include "com/centreon/connector/ssh/multiplexer.hh"
-#include "com/centreon/connector/ssh/sessions/session.hh"
-#include "com/centreon/delayed_delete.hh"
+#include "com/centreon/connector/ssh/options.hh"
+#include "com/centreon/connector/ssh/sessions/credentials.hh"
 
 using namespace com::centreon::connector::ssh;
 
@@ -41,17 +39,55 @@ extern std::atomic<bool> should_exit;
  **************************************/
 
 /**
- *  Default constructor.
+ *  Constructor.
+ *
+ *  @param[in] opts Program options.
  */
-policy::policy() : _sin(stdin), _sout(stdout) {
+policy::policy(options const& opts)
+    : _agents(_agent_socket()),
+      _compress(opts.get_argument("compress").get_is_set()),
+      _error(false),
+      _in_flight(0),
+      _limiter(opts.get_unsigned("max-handshakes"),
+               opts.get_unsigned("max-host-handshakes")),
+      _next_id(orders::parser::first_reserved_id),
+      _results_notifier([this]() { _report_results(); }),
+      _sin(stdin),
+      _sout(stdout) {
+  if (_compress)
+    log::core()->info("SSH transport compression enabled for all checks");
+  if (_agents.is_enabled())
+    log::core()->info(
+        "ssh-agent authentication enabled through {0}, tried when password "
+        "authentication fails",
+        _agents.get_socket_path());
+  if (_limiter.is_enabled())
+    log::core()->info(
+        "new SSH handshakes limited to {0}/s globally and {1}/s per host "
+        "(0 means unlimited)",
+        opts.get_unsigned("max-handshakes"),
+        opts.get_unsigned("max-host-handshakes"));
+
   // Send information back.
-  multiplexer::instance().handle_manager::add(&_sout, &_reporter);
+  multiplexer::instance().reactor::add(&_sout, &_reporter);
+  multiplexer::instance().reactor::add(&_results_notifier,
+                                       &_results_notifier);
+
+  // Start workers.
+  unsigned int threads(opts.get_unsigned("threads", 1));
+  if (!threads)
+    threads = 1;
+  size_t max_output_size(opts.get_unsigned("max-output-size"));
+  log::core()->info("starting {} worker threads", threads);
+  for (unsigned int i = 0; i < threads; ++i)
+    _workers.emplace_back(new worker(i, _limiter, _agents, max_output_size,
+                                     _results, _results_notifier));
 
   // Listen orders.
   _parser.listen(this);
 
   // Parser listens stdin.
-  multiplexer::instance().handle_manager::add(&_sin, &_parser);
+  multiplexer::instance().reactor::add(&_sin, &_parser);
 }
 
 /**
@@ -60,28 +96,18 @@ policy::policy() : _sin(stdin), _sout(stdout) {
 policy::~policy() noexcept {
   try {
     // Remove from multiplexer.
-    multiplexer::instance().handle_manager::remove(&_sin);
-    multiplexer::instance().handle_manager::remove(&_sout);
+    multiplexer::instance().reactor::remove(&_sin);
+    multiplexer::instance().reactor::remove(&_sout);
   } catch (...) {
   }
 
-  // Close checks.
-  for (auto& c : _checks) {
-    try {
-      c.second.first->unlisten(this);
-    } catch (...) {
-    }
-    delete c.second.first;
-  }
-  _checks.clear();
+  // Stop workers, they close their checks and sessions.
+  _workers.clear();
 
-  // Close sessions.
-  for (auto& _session : _sessions) {
-    try {
-      _session.second->close();
-    } catch (...) {
-    }
-    delete _session.second;
+  try {
+    multiplexer::instance().reactor::remove(
+        static_cast<com::centreon::handle*>(&_results_notifier));
+  } catch (...) {
   }
 }
 
@@ -105,7 +131,8 @@ void policy::on_error(uint64_t cmd_id, char const* msg) {
     r.set_command_id(cmd_id);
     r.set_executed(false);
     r.set_error(msg);
-    on_result(r);
+    _reporter.send_result(r);
+    multiplexer::instance().reactor::update(&_sout);
   } else {
     log::core()->info("error occurred while parsing stdin");
     _error = true;
@@ -127,6 +154,8 @@ void policy::on_error(uint64_t cmd_id, char const* msg) {
  *  @param[in] skip_stdout Ignore all or first n output lines.
  *  @param[in] skip_stderr Ignore all or first n error lines.
  *  @param[in] use_ipv6    Version of ip protocol to use.
+ *  @param[in] compress    Compress SSH transport.
+ *  @param[in] builtin     Commands are built-in checks.
  */
 void policy::on_execute(uint64_t cmd_id,
                         const timestamp& timeout,
@@ -138,7 +167,9 @@ void policy::on_execute(uint64_t cmd_id,
                         std::list<std::string> const& cmds,
                         int skip_stdout,
                         int skip_stderr,
-                        bool use_ipv6) {
+                        bool use_ipv6,
+                        bool compress,
+                        bool builtin) {
   try {
     // Log message.
     log::core()->info(
@@ -146,39 +177,23 @@ void policy::on_execute(uint64_t cmd_id,
         "first command \"{4}\")",
         cmd_id, user, host, timeout.to_seconds(), cmds.front());
 
-    // Credentials.
-    sessions::credentials creds;
-    creds.set_host(host);
-    creds.set_user(user);
-    creds.set_password(password);
-    creds.set_port(port);
-    creds.set_key(key);
-
-    // Object lock.
-    std::unique_lock<std::mutex> lock(_mutex);
-
-    // Find session.
-    auto it = _sessions.find(creds);
-    if (it == _sessions.end()) {
-      log::core()->info("creating session for {0}@{1}:{2}", user, host, port);
-      std::unique_ptr<sessions::session> sess{new sessions::session(creds)};
-      sess->connect(use_ipv6);
-      _sessions[creds] = sess.release();
-      it = _sessions.find(creds);
-    }
-
-    sessions::session* sess = it->second;
-
-    // Create check object.
-    checks::check* chk_ptr = new checks::check(skip_stdout, skip_stderr);
-    chk_ptr->listen(this);
-    _checks[cmd_id] = std::make_pair(chk_ptr, sess);
-
-    // Release lock and run copied pointer (we might be called in
-    // on_result() and mutex must be available).
-    lock.unlock();
-
-    chk_ptr->execute(*sess, cmd_id, cmds, timeout);
+    // Build order.
+    worker::order o;
+    o.cmd_id = cmd_id;
+    o.timeout = timeout;
+    o.creds.set_host(host);
+    o.creds.set_user(user);
+    o.creds.set_password(password);
+    o.creds.set_port(port);
+    o.creds.set_key(key);
+    o.creds.set_compress(compress || _compress);
+    o.cmds = cmds;
+    o.skip_stdout = skip_stdout;
+    o.skip_stderr = skip_stderr;
+    o.use_ipv6 = use_ipv6;
+    o.use_builtin = builtin;
+
+    _dispatch(std::move(o));
   } catch (std::exception const& e) {
     log::core()->error(
         "could not launch check ID {0} on host {1} because an error occurred: "
@@ -186,91 +201,102 @@ void policy::on_execute(uint64_t cmd_id,
         cmd_id, host, e.what());
     checks::result r;
     r.set_command_id(cmd_id);
-    on_result(r);
-  } catch (...) {
-    log::core()->error(
-        "could not launch check ID {0} on host {1} because an error occurred",
-        cmd_id, host);
-    checks::result r;
-    r.set_command_id(cmd_id);
-    on_result(r);
+    _reporter.send_result(r);
+    multiplexer::instance().reactor::update(&_sout);
   }
 }
 
 /**
- *  Quit order was received.
- */
-void policy::on_quit() {
-  // Exiting.
-  log::core()->info("quit request received");
-  should_exit = true;
-  multiplexer::instance().handle_manager::remove(&_sin);
-}
-
-/**
- *  Check result has arrived.
+ *  @brief Fan-out execution command received.
  *
- *  @param[in] r Check result.
+ *  The command is run on every host, each under its own command ID
+ *  taken from the range the parser reserves, so that it cannot
+ *  collide with orders of the monitoring engine. The monitoring engine
+ *  accepts a single result per command ID, host results are
+ *  aggregated into one result reported under cmd_id.
+ *
+ *  @param[in] cmd_id      Command ID.
+ *  @param[in] timeout     Time the command has to execute.
+ *  @param[in] hosts       Target hosts.
+ *  @param[in] port        Connection port.
+ *  @param[in] user        User.
+ *  @param[in] password    Password.
+ *  @param[in] key         Identity file.
+ *  @param[in] cmds        Commands to execute.
+ *  @param[in] skip_stdout Ignore all or first n output lines.
+ *  @param[in] skip_stderr Ignore all or first n error lines.
+ *  @param[in] use_ipv6    Version of ip protocol to use.
+ *  @param[in] compress    Compress SSH transport.
+ *  @param[in] builtin     Commands are built-in checks.
  */
-void policy::on_result(checks::result const& r) {
-  // Object lock.
-  std::lock_guard<std::mutex> lock(_mutex);
-
-  // Remove check from list.
-  std::map<uint64_t, std::pair<checks::check*, sessions::session*> >::iterator
-      chk;
-  chk = _checks.find(r.get_command_id());
-  if (chk == _checks.end())
-    log::core()->error("got result of check {} which is not registered",
-                       r.get_command_id());
-  else {
+void policy::on_execute_many(uint64_t cmd_id,
+                             const timestamp& timeout,
+                             std::vector<std::string> const& hosts,
+                             unsigned short port,
+                             std::string const& user,
+                             std::string const& password,
+                             std::string const& key,
+                             std::list<std::string> const& cmds,
+                             int skip_stdout,
+                             int skip_stderr,
+                             bool use_ipv6,
+                             bool compress,
+                             bool builtin) {
+  log::core()->info(
+      "got request to execute check {0} on {1} hosts as {2} (timeout {3}, "
+      "first command \"{4}\")",
+      cmd_id, hosts.size(), user, timeout.to_seconds(), cmds.front());
+
+  // Build the common part of orders once.
+  worker::order o;
+  o.timeout = timeout;
+  o.creds.set_user(user);
+  o.creds.set_password(password);
+  o.creds.set_port(port);
+  o.creds.set_key(key);
+  o.creds.set_compress(compress || _compress);
+  o.cmds = cmds;
+  o.skip_stdout = skip_stdout;
+  o.skip_stderr = skip_stderr;
+  o.use_ipv6 = use_ipv6;
+  o.use_builtin = builtin;
+
+  std::shared_ptr<checks::batch> b(
+      std::make_shared<checks::batch>(cmd_id, hosts));
+
+  for (size_t i = 0; i < hosts.size(); ++i) {
+    unsigned long long host_id(_next_id++);
+    worker::order host_order(o);
+    host_order.cmd_id = host_id;
+    host_order.creds.set_host(hosts[i]);
+    _fan_outs[host_id] = fan_out_host{b, i};
+    log::core()->debug("check {0} runs on host {1} as check {2}", cmd_id,
+                       hosts[i], host_id);
     try {
-      chk->second.first->unlisten(this);
-      chk->second.second->unlisten(chk->second.first);
-    } catch (...) {
-    }
-    delete chk->second.first;
-    sessions::session* sess(chk->second.second);
-    _checks.erase(chk);
-
-    // Check session.
-    if (!sess->is_connected()) {
-      log::core()->debug(
-          "session {} is not connected, checking if any check working with it "
-          "remains",
-          static_cast<void*>(sess));
-      bool found(false);
-      for (auto& _check : _checks)
-        if (_check.second.second == sess) {
-          found = true;
-          break;
-        }
-      if (!found) {
-        std::map<sessions::credentials, sessions::session*>::iterator it, end;
-        for (it = _sessions.begin(), end = _sessions.end(); it != end; ++it) {
-          if (it->second == sess)
-            break;
-        }
-        if (it == end)
-          log::core()->error(
-              "session {} was not found in policy list, deleting anyway",
-              static_cast<void*>(sess));
-        else {
-          log::core()->info(
-              "session {0}@{1}:{2} that is not connected and has no check "
-              "running will be deleted",
-              it->first.get_user(), it->first.get_host(), it->first.get_port());
-          _sessions.erase(it);
-        }
-        delayed_delete<sessions::session>* dd =
-            new delayed_delete<sessions::session>(sess);
-        multiplexer::instance().task_manager::add(dd, 0, true, true);
-      }
+      _dispatch(std::move(host_order));
+    } catch (std::exception const& e) {
+      log::core()->error(
+          "could not launch check ID {0} on host {1} because an error "
+          "occurred: {2}",
+          cmd_id, hosts[i], e.what());
+      checks::result r;
+      r.set_command_id(host_id);
+      r.set_error(e.what());
+      ++_in_flight;
+      _results.push(std::move(r));
     }
   }
+  _report_results();
+}
 
-  // Send check result back to monitoring engine.
-  _reporter.send_result(r);
+/**
+ *  Quit order was received.
+ */
+void policy::on_quit() {
+  // Exiting.
+  log::core()->info("quit request received");
+  should_exit = true;
+  multiplexer::instance().reactor::remove(&_sin);
 }
 
 /**
@@ -281,6 +307,7 @@ void policy::on_version() {
   log::core()->info(
       "monitoring engine requested protocol version, sending 1.0");
   _reporter.send_version(1, 0);
+  multiplexer::instance().reactor::update(&_sout);
 }
 
 /**
@@ -292,16 +319,18 @@ bool policy::run() {
   // No error occurred yet.
   _error = false;
 
-  // Run multiplexer.
-  while (!should_exit) {
+  // Run multiplexer. Checks of a failed worker would never terminate,
+  // the connector then exits with an error like when its multiplexer
+  // fails.
+  while (!should_exit && !_workers_failed()) {
     log::core()->debug("multiplexing");
     multiplexer::instance().multiplex();
   }
 
   // Run as long as a check remains.
   log::core()->info("waiting for checks to terminate");
-  while (!_checks.empty()) {
-    log::core()->debug("multiplexing remaining checks ({})", _checks.size());
+  while (_in_flight && !_workers_failed()) {
+    log::core()->debug("multiplexing remaining checks ({})", _in_flight);
     multiplexer::instance().multiplex();
   }
 
@@ -314,3 +343,70 @@ bool policy::run() {
 
   return !_error;
 }
+
+/**************************************
+ *                                     *
+ *           Private Methods           *
+ *                                     *
+ **************************************/
+
+/**
+ *  Get the path of the ssh-agent socket.
+ *
+ *  @return Value of SSH_AUTH_SOCK, empty if not set.
+ */
+std::string policy::_agent_socket() {
+  char const* path(getenv("SSH_AUTH_SOCK"));
+  return path ? path : "";
+}
+
+/**
+ *  Send an order to its worker.
+ *
+ *  @param[in] o Order.
+ */
+void policy::_dispatch(worker::order&& o) {
+  // Sessions with the same credentials always go to the same worker.
+  worker& w(*_workers[o.creds.hash() % _workers.size()]);
+  w.execute(std::move(o));
+  ++_in_flight;
+}
+
+/**
+ *  Send check results received from workers back to monitoring
+ *  engine. Results of fan-out hosts are held until the batch of their
+ *  order is complete.
+ */
+void policy::_report_results() {
+  _results.consume([this](checks::result&& r) {
+    if (_in_flight)
+      --_in_flight;
+    auto it(_fan_outs.find(r.get_command_id()));
+    if (it == _fan_outs.end())
+      _reporter.send_result(r);
+    else {
+      fan_out_host fo(std::move(it->second));
+      _fan_outs.erase(it);
+      fo.b->add(fo.index, r);
+      if (fo.b->is_complete())
+        _reporter.send_result(fo.b->get_result());
+    }
+  });
+  multiplexer::instance().reactor::update(&_sout);
+}
+
+/**
+ *  Check whether a worker failed.
+ *
+ *  @return true if a worker failed.
+ */
+bool policy::_workers_failed() {
+  for (std::unique_ptr<worker> const& w : _workers)
+    if (w->has_failed()) {
+      if (!_error)
+        log::core()->error("a worker failed, exiting");
+      _error = true;
+      return true;
+    }
+  return false;
+}
@@ -0,0 +1,125 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#include "com/centreon/connector/ssh/sessions/agent_cache.hh"
+
+#include <string>
+
+using namespace com::centreon::connector::ssh::sessions;
+
+/**************************************
+ *                                     *
+ *           Public Methods            *
+ *                                     *
+ **************************************/
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] socket_path Path of the ssh-agent socket (usually the
+ *                         value of SSH_AUTH_SOCK), empty to disable
+ *                         agent authentication.
+ */
+agent_cache::agent_cache(std::string const& socket_path)
+    : _socket_path(socket_path) {}
+
+/**
+ *  Forget the identity that opened a destination, it was refused.
+ *
+ *  @param[in] creds Session credentials.
+ */
+void agent_cache::forget(credentials const& creds) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _identities.erase(_key(creds));
+}
+
+/**
+ *  Get the public key blob of the identity that opened a destination.
+ *
+ *  @param[in] creds Session credentials.
+ *
+ *  @return Public key blob, empty if none is known.
+ */
+std::string agent_cache::get_identity(credentials const& creds) const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto it(_identities.find(_key(creds)));
+  return it == _identities.end() ? std::string() : it->second;
+}
+
+/**
+ *  Get the ssh-agent socket path.
+ *
+ *  @return Socket path.
+ */
+std::string const& agent_cache::get_socket_path() const noexcept {
+  return _socket_path;
+}
+
+/**
+ *  Check if agent authentication can be attempted.
+ *
+ *  @return true if an agent socket is configured.
+ */
+bool agent_cache::is_enabled() const noexcept {
+  return !_socket_path.empty();
+}
+
+/**
+ *  Remember the identity that opened a destination.
+ *
+ *  @param[in] creds Session credentials.
+ *  @param[in] blob  Public key blob of the identity.
+ */
+void agent_cache::set_identity(credentials const& creds,
+                               std::string const& blob) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _identities[_key(creds)] = blob;
+}
+
+/**
+ *  Get the number of destinations with a known identity.
+ *
+ *  @return Number of cached identities.
+ */
+size_t agent_cache::size() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _identities.size();
+}
+
+/**************************************
+ *                                     *
+ *           Private Methods           *
+ *                                     *
+ **************************************/
+
+/**
+ *  Build the cache key of a destination. Password, key file and
+ *  compression do not matter to the agent.
+ *
+ *  @param[in] creds Session credentials.
+ *
+ *  @return Cache key.
+ */
+std::string agent_cache::_key(credentials const& creds) {
+  std::string retval(creds.get_user());
+  retval.append("@");
+  retval.append(creds.get_host());
+  retval.append(":");
+  retval.append(std::to_string(creds.get_port()));
+  return retval;
+}
@@ -0,0 +1,287 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#include "com/centreon/connector/ssh/sessions/allocator.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+using namespace com::centreon::connector::ssh::sessions;
+
+namespace {
+// Block header, it keeps the alignment of memory returned by malloc().
+struct alignas(16) header {
+  size_t size;
+  unsigned int size_class;
+};
+
+// Free block of a pool.
+struct free_block {
+  free_block* next;
+};
+
+// Pools serve blocks from 64 bytes to 16 KB (header included).
+unsigned int const min_class_bits = 6;
+unsigned int const size_classes = 9;
+unsigned int const large_class = size_classes;
+
+// Memory kept for reuse by each pool of a thread.
+size_t const max_cached_bytes = 256 * 1024;
+
+/**
+ *  Get the size of blocks of a size class.
+ *
+ *  @param[in] size_class Size class.
+ *
+ *  @return Block size in bytes.
+ */
+size_t block_size(unsigned int size_class) noexcept {
+  return static_cast<size_t>(1) << (size_class + min_class_bits);
+}
+
+/**
+ *  Get the size class able to hold an allocation.
+ *
+ *  @param[in] size Requested size.
+ *
+ *  @return Size class, large_class if no pool can hold it.
+ */
+unsigned int class_of(size_t size) noexcept {
+  size_t total(size + sizeof(header));
+  for (unsigned int c(0); c < size_classes; ++c)
+    if (total <= block_size(c))
+      return c;
+  return large_class;
+}
+
+/**
+ *  Free lists of the calling thread. Sessions are only used by the
+ *  thread that created them so no lock is needed.
+ */
+class pools {
+  size_t _counts[size_classes];
+  free_block* _free[size_classes];
+
+ public:
+  pools() : _counts{}, _free{} {}
+  pools(pools const& p) = delete;
+  pools& operator=(pools const& p) = delete;
+
+  ~pools() noexcept {
+    for (free_block* b : _free)
+      while (b) {
+        free_block* next(b->next);
+        ::free(b);
+        b = next;
+      }
+  }
+
+  void* get(unsigned int size_class) noexcept {
+    free_block* b(_free[size_class]);
+    if (!b)
+      return malloc(block_size(size_class));
+    _free[size_class] = b->next;
+    --_counts[size_class];
+    return b;
+  }
+
+  void put(unsigned int size_class, void* block) noexcept {
+    if (_counts[size_class] * block_size(size_class) >= max_cached_bytes)
+      ::free(block);
+    else {
+      free_block* b(static_cast<free_block*>(block));
+      b->next = _free[size_class];
+      _free[size_class] = b;
+      ++_counts[size_class];
+    }
+  }
+};
+
+thread_local pools local_pools;
+}  // namespace
+
+// Memory allocated by all sessions.
+std::atomic<size_t> allocator::_total(0);
+
+/**************************************
+ *                                     *
+ *           Public Methods            *
+ *                                     *
+ **************************************/
+
+/**
+ *  Constructor.
+ */
+allocator::allocator() : _allocated(0), _peak(0) {}
+
+/**
+ *  Destructor.
+ */
+allocator::~allocator() noexcept {
+  _total.fetch_sub(_allocated, std::memory_order_relaxed);
+}
+
+/**
+ *  Allocate memory.
+ *
+ *  @param[in] size Requested size.
+ *
+ *  @return Allocated memory, nullptr on failure.
+ */
+void* allocator::allocate(size_t size) {
+  unsigned int size_class(class_of(size));
+  void* block(size_class == large_class ? malloc(size + sizeof(header))
+                                        : local_pools.get(size_class));
+  if (!block)
+    return nullptr;
+  header* h(static_cast<header*>(block));
+  h->size = size;
+  h->size_class = size_class;
+  _account(0, size);
+  return h + 1;
+}
+
+/**
+ *  Release memory.
+ *
+ *  @param[in] ptr Memory returned by allocate() or reallocate().
+ */
+void allocator::deallocate(void* ptr) noexcept {
+  if (!ptr)
+    return;
+  header* h(static_cast<header*>(ptr) - 1);
+  _account(h->size, 0);
+  if (h->size_class == large_class)
+    ::free(h);
+  else
+    local_pools.put(h->size_class, h);
+}
+
+/**
+ *  Get the memory currently allocated by the session.
+ *
+ *  @return Size in bytes.
+ */
+size_t allocator::get_allocated() const noexcept {
+  return _allocated;
+}
+
+/**
+ *  Get the maximum memory allocated at once by the session.
+ *
+ *  @return Size in bytes.
+ */
+size_t allocator::get_peak() const noexcept {
+  return _peak;
+}
+
+/**
+ *  Get the memory currently allocated by all sessions.
+ *
+ *  @return Size in bytes.
+ */
+size_t allocator::get_total_allocated() noexcept {
+  return _total.load(std::memory_order_relaxed);
+}
+
+/**
+ *  Resize memory.
+ *
+ *  @param[in] ptr  Memory returned by allocate() or reallocate().
+ *  @param[in] size New size.
+ *
+ *  @return Resized memory, nullptr on failure (ptr is then left
+ *          untouched).
+ */
+void* allocator::reallocate(void* ptr, size_t size) {
+  if (!ptr)
+    return allocate(size);
+
+  // The current block is large enough.
+  header* h(static_cast<header*>(ptr) - 1);
+  unsigned int size_class(class_of(size));
+  if (size_class == h->size_class && size_class != large_class) {
+    _account(h->size, size);
+    h->size = size;
+    return ptr;
+  }
+
+  // Large blocks are resized by the heap.
+  if (size_class == large_class && h->size_class == large_class) {
+    size_t old_size(h->size);
+    header* resized(
+        static_cast<header*>(realloc(h, size + sizeof(header))));
+    if (!resized)
+      return nullptr;
+    resized->size = size;
+    _account(old_size, size);
+    return resized + 1;
+  }
+
+  // Move to another block.
+  void* moved(allocate(size));
+  if (!moved)
+    return nullptr;
+  memcpy(moved, ptr, std::min(h->size, size));
+  deallocate(ptr);
+  return moved;
+}
+
+/**
+ *  libssh2 allocation hook.
+ */
+LIBSSH2_ALLOC_FUNC(allocator::libssh2_alloc) {
+  return static_cast<allocator*>(*abstract)->allocate(count);
+}
+
+/**
+ *  libssh2 release hook.
+ */
+LIBSSH2_FREE_FUNC(allocator::libssh2_free) {
+  static_cast<allocator*>(*abstract)->deallocate(ptr);
+}
+
+/**
+ *  libssh2 reallocation hook.
+ */
+LIBSSH2_REALLOC_FUNC(allocator::libssh2_realloc) {
+  return static_cast<allocator*>(*abstract)->reallocate(ptr, count);
+}
+
+/**************************************
+ *                                     *
+ *           Private Methods           *
+ *                                     *
+ **************************************/
+
+/**
+ *  Update memory counters.
+ *
+ *  @param[in] released Bytes released.
+ *  @param[in] acquired Bytes acquired.
+ */
+void allocator::_account(size_t released, size_t acquired) noexcept {
+  _allocated = _allocated - released + acquired;
+  if (_allocated > _peak)
+    _peak = _allocated;
+  if (acquired > released)
+    _total.fetch_add(acquired - released, std::memory_order_relaxed);
+  else
+    _total.fetch_sub(released - acquired, std::memory_order_relaxed);
+}
@@ -0,0 +1,175 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#include "com/centreon/connector/ssh/sessions/connect_queue.hh"
+
+#include <algorithm>
+#include <iterator>
+
+#include "com/centreon/connector/log.hh"
+#include "com/centreon/connector/ssh/multiplexer.hh"
+#include "com/centreon/connector/ssh/sessions/session.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::connector;
+using namespace com::centreon::connector::ssh::sessions;
+
+/**************************************
+ *                                     *
+ *           Public Methods            *
+ *                                     *
+ **************************************/
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] limiter Handshake limiter used to pace connections.
+ */
+connect_queue::connect_queue(handshake_limiter& limiter)
+    : _limiter(limiter), _task_id(0) {}
+
+/**
+ *  Destructor.
+ */
+connect_queue::~connect_queue() noexcept {
+  if (_task_id) {
+    try {
+      multiplexer::instance().com::centreon::task_manager::remove(_task_id);
+    } catch (...) {
+    }
+  }
+}
+
+/**
+ *  Remove a session from the queue. This must be called before the
+ *  session is deleted.
+ *
+ *  @param[in] sess Session.
+ */
+void connect_queue::cancel(session* sess) {
+  auto it(_index.find(sess));
+  if (it != _index.end()) {
+    log::core()->debug("session {} removed from connection queue",
+                       static_cast<void*>(sess));
+    _pending.erase(it->second);
+    _index.erase(it);
+  }
+}
+
+/**
+ *  Connect a session as soon as the handshake rate allows it.
+ *
+ *  @param[in] sess     Session to connect.
+ *  @param[in] use_ipv6 Connect with IPv6.
+ *  @param[in] deadline Deadline of the check that opened the session.
+ *                      Sessions are queued by deadline.
+ */
+void connect_queue::connect(session* sess,
+                            bool use_ipv6,
+                            timestamp const& deadline) {
+  auto pos(_pending.end());
+  while (pos != _pending.begin() && deadline < std::prev(pos)->deadline)
+    --pos;
+  _index[sess] = _pending.insert(pos, pending{sess, use_ipv6, deadline});
+  if (!_task_id)
+    _drain();
+  else
+    log::core()->debug("session {0} queued for connection ({1} waiting)",
+                       static_cast<void*>(sess), _pending.size());
+}
+
+/**
+ *  Connect sessions whose turn has come.
+ */
+void connect_queue::run() {
+  _task_id = 0;
+  _drain();
+}
+
+/**
+ *  Get the number of sessions waiting to connect.
+ *
+ *  @return Number of queued sessions.
+ */
+size_t connect_queue::size() const noexcept {
+  return _pending.size();
+}
+
+/**************************************
+ *                                     *
+ *           Private Methods           *
+ *                                     *
+ **************************************/
+
+/**
+ *  Start all sessions allowed by the limiter and schedule the next
+ *  attempt if some sessions remain.
+ */
+void connect_queue::_drain() {
+  // Extract sessions that can connect. Destinations that reached their
+  // own limit are skipped, others keep their place in the queue.
+  std::list<pending> ready;
+  std::chrono::milliseconds next(0);
+  for (auto it(_pending.begin()); it != _pending.end();) {
+    std::chrono::milliseconds wait;
+    if (_limiter.acquire(it->sess->get_credentials().get_host(), wait)) {
+      auto current(it++);
+      _index.erase(current->sess);
+      ready.splice(ready.end(), _pending, current);
+    } else {
+      if (!next.count() || wait < next)
+        next = wait;
+      if (_limiter.is_saturated())
+        break;
+      ++it;
+    }
+  }
+
+  // Schedule next attempt.
+  if (!_pending.empty() && !_task_id) {
+    log::core()->debug(
+        "{0} sessions waiting for connection, next attempt in {1}ms",
+        _pending.size(), next.count());
+    timestamp when(timestamp::now());
+    when.add_mseconds(std::max<long>(next.count(), 1));
+    _task_id = multiplexer::instance().com::centreon::task_manager::add(
+        this, when, false, false);
+  }
+
+  // Launch connections. This is done last because a failing session
+  // notifies its checks which can modify the queue.
+  for (pending const& p : ready)
+    _start(p);
+}
+
+/**
+ *  Launch the connection process of a session.
+ *
+ *  @param[in] p Queued session.
+ */
+void connect_queue::_start(pending const& p) {
+  try {
+    p.sess->connect(p.use_ipv6);
+  } catch (std::exception const& e) {
+    credentials const& creds(p.sess->get_credentials());
+    log::core()->error("could not connect session {0}@{1}:{2}: {3}",
+                       creds.get_user(), creds.get_host(), creds.get_port(),
+                       e.what());
+    p.sess->close();
+  }
+}
@@ -17,6 +17,7 @@
 */
 
 #include "com/centreon/connector/ssh/sessions/credentials.hh"
+#include <initializer_list>
 
 using namespace com::centreon::connector::ssh::sessions;
 
@@ -30,9 +31,11 @@ using namespace com::centreon::connector::ssh::sessions;
  *  @brief Default constructor.
  *
  *  Host, user, password and identity are all empty after construction.
- *  Port number are set to 22 by default.
+ *  Port number are set to 22 by default and compression is disabled.
  */
-credentials::credentials() : _port(22) {}
+credentials::credentials() : _compress(false), _port(22) {
+  _update_hash();
+}
 
 /**
  *  Constructor.
@@ -48,7 +51,14 @@ credentials::credentials(std::string const& host,
                          std::string const& password,
                          std::string const& key,
                          unsigned short port)
-    : _host(host), _key(key), _password(password), _port(port), _user(user) {}
+    : _compress(false),
+      _host(host),
+      _key(key),
+      _password(password),
+      _port(port),
+      _user(user) {
+  _update_hash();
+}
 
 /**
  *  Copy constructor.
@@ -80,8 +90,9 @@ credentials& credentials::operator=(credentials const& c) {
  *  @return true if both objects are equal.
  */
 bool credentials::operator==(credentials const& c) const {
-  return ((_port == c._port) && (_host == c._host) && (_key == c._key) &&
-          (_password == c._password) && (_user == c._user));
+  return ((_hash == c._hash) && (_port == c._port) &&
+          (_compress == c._compress) && (_host == c._host) &&
+          (_key == c._key) && (_password == c._password) && (_user == c._user));
 }
 
 /**
@@ -115,11 +126,22 @@ bool credentials::operator<(credentials const& c) const {
     retval = (_port < c._port);
   else if (_key != c._key)
     retval = (_key < c._key);
+  else if (_compress != c._compress)
+    retval = (_compress < c._compress);
   else
     retval = false;
   return (retval);
 }
 
+/**
+ *  Check whether transport compression is requested.
+ *
+ *  @return true if the session must be compressed.
+ */
+bool credentials::get_compress() const {
+  return (_compress);
+}
+
 /**
  *  Get the host.
  *
@@ -165,6 +187,25 @@ std::string const& credentials::get_user() const {
   return (_user);
 }
 
+/**
+ *  Get the hash of these credentials.
+ *
+ *  @return Hash value.
+ */
+size_t credentials::hash() const noexcept {
+  return (_hash);
+}
+
+/**
+ *  Enable or disable transport compression.
+ *
+ *  @param[in] compress true to compress the session.
+ */
+void credentials::set_compress(bool compress) {
+  _compress = compress;
+  _update_hash();
+}
+
 /**
  *  Set key file.
  *
@@ -172,6 +213,7 @@ std::string const& credentials::get_user() const {
  */
 void credentials::set_key(std::string const& file) {
   _key = file;
+  _update_hash();
 }
 
 /**
@@ -181,6 +223,7 @@ void credentials::set_key(std::string const& file) {
  */
 void credentials::set_host(std::string const& host) {
   _host = host;
+  _update_hash();
 }
 
 /**
@@ -190,6 +233,7 @@ void credentials::set_host(std::string const& host) {
  */
 void credentials::set_password(std::string const& password) {
   _password = password;
+  _update_hash();
 }
 
 /**
@@ -199,6 +243,7 @@ void credentials::set_password(std::string const& password) {
  */
 void credentials::set_port(unsigned short port) {
   _port = port;
+  _update_hash();
 }
 
 /**
@@ -208,6 +253,7 @@ void credentials::set_port(unsigned short port) {
  */
 void credentials::set_user(std::string const& user) {
   _user = user;
+  _update_hash();
 }
 
 /**************************************
@@ -222,9 +268,24 @@ void credentials::set_user(std::string const& user) {
  *  @param[in] c Object to copy.
  */
 void credentials::_copy(credentials const& c) {
+  _compress = c._compress;
+  _hash = c._hash;
   _host = c._host;
   _key = c._key;
   _password = c._password;
   _port = c._port;
   _user = c._user;
 }
+
+/**
+ *  Compute the hash of all members.
+ */
+void credentials::_update_hash() {
+  std::hash<std::string> h;
+  size_t retval(std::hash<unsigned short>()(_port) ^
+                 (_compress ? static_cast<size_t>(0x5bd1e995) : 0));
+  for (std::string const* str : {&_host, &_user, &_password, &_key})
+    retval ^= h(*str) + static_cast<size_t>(0x9e3779b97f4a7c15ULL) +
+              (retval << 6) + (retval >> 2);
+  _hash = retval;
+}
@@ -0,0 +1,119 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#include "com/centreon/connector/ssh/sessions/handshake_limiter.hh"
+
+#include <algorithm>
+
+using namespace com::centreon::connector::ssh::sessions;
+
+// Minimum number of host buckets before idle ones get pruned.
+static size_t const min_prune_size = 1024;
+
+/**************************************
+ *                                     *
+ *           Public Methods            *
+ *                                     *
+ **************************************/
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] rate      Maximum number of new handshakes per second, 0
+ *                       for no limit.
+ *  @param[in] host_rate Maximum number of new handshakes per second
+ *                       toward a single host, 0 for no limit.
+ */
+handshake_limiter::handshake_limiter(unsigned int rate, unsigned int host_rate)
+    : _global(rate), _host_rate(host_rate), _prune_size(min_prune_size) {}
+
+/**
+ *  Try to get the right to start a new handshake toward a host.
+ *
+ *  @param[in]  host Destination host.
+ *  @param[out] wait If handshake is not allowed, time to wait before
+ *                   trying again.
+ *
+ *  @return true if handshake can be started now.
+ */
+bool handshake_limiter::acquire(std::string const& host,
+                                std::chrono::milliseconds& wait) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  token_bucket::clock::time_point now(token_bucket::clock::now());
+  wait = _global.wait_time(now);
+  token_bucket* host_bucket(nullptr);
+  if (_host_rate) {
+    auto it(_hosts.find(host));
+    if (it == _hosts.end()) {
+      _prune(now);
+      it = _hosts.emplace(host, token_bucket(_host_rate)).first;
+    }
+    host_bucket = &it->second;
+    wait = std::max(wait, host_bucket->wait_time(now));
+  }
+  if (wait.count())
+    return false;
+
+  _global.consume();
+  if (host_bucket)
+    host_bucket->consume();
+  return true;
+}
+
+/**
+ *  Check if limiter has any limit configured.
+ *
+ *  @return true if handshakes are limited.
+ */
+bool handshake_limiter::is_enabled() const noexcept {
+  return _global.is_limited() || _host_rate;
+}
+
+/**
+ *  Check if the global limit is reached.
+ *
+ *  @return true if no handshake can be started right now, whatever
+ *          the host.
+ */
+bool handshake_limiter::is_saturated() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _global.wait_time(token_bucket::clock::now()).count() != 0;
+}
+
+/**************************************
+ *                                     *
+ *           Private Methods           *
+ *                                     *
+ **************************************/
+
+/**
+ *  Remove buckets of hosts that were not contacted recently.
+ *
+ *  @param[in] now Current time.
+ */
+void handshake_limiter::_prune(token_bucket::clock::time_point now) {
+  if (_hosts.size() < _prune_size)
+    return;
+  for (auto it(_hosts.begin()); it != _hosts.end();) {
+    if (it->second.is_full(now))
+      it = _hosts.erase(it);
+    else
+      ++it;
+  }
+  _prune_size = std::max(min_prune_size, _hosts.size() * 2);
+}
@@ -29,10 +29,12 @@
 
 #include <cerrno>
 #include <cstring>
+#include <functional>
 #include <memory>
 
 #include "com/centreon/connector/log.hh"
 #include "com/centreon/connector/ssh/multiplexer.hh"
+#include "com/centreon/connector/ssh/sessions/agent_cache.hh"
 #include "com/centreon/exceptions/basic.hh"
 
 using namespace com::centreon;
@@ -48,18 +50,33 @@ using namespace com::centreon::connector::ssh::sessions;
 /**
  *  Constructor.
  *
- *  @param[in] creds Connection credentials.
+ *  @param[in] creds  Connection credentials.
+ *  @param[in] agents ssh-agent identity cache shared by all sessions,
+ *                    nullptr to disable agent authentication.
  */
-session::session(credentials const& creds)
-    : _creds(creds),
+session::session(credentials const& creds, agent_cache* agents)
+    : _agent_handle(nullptr),
+      _agent_index(0),
+      _agents(agents),
+      _checks_count(0),
+      _creds(creds),
       _needed_new_chan(false),
       _session(nullptr),
+      _sftp(nullptr),
+      _sftp_owner(nullptr),
       _step(session_startup),
       _step_string("startup") {
-  // Create session instance.
-  _session = libssh2_session_init();
+  // Create session instance, its memory is served by our allocator.
+  _session = libssh2_session_init_ex(
+      &allocator::libssh2_alloc, &allocator::libssh2_free,
+      &allocator::libssh2_realloc, &_allocator);
   if (!_session)
     throw basic_error() << "SSH session creation failed (out of memory ?)";
+
+  // Compression is negotiated during the handshake, it must be
+  // requested before.
+  if (_creds.get_compress())
+    libssh2_session_flag(_session, LIBSSH2_FLAG_COMPRESS, 1);
 }
 
 /**
@@ -71,10 +88,25 @@ session::~session() noexcept {
   } catch (...) {
   }
 
+  // The agent handle is bound to the session.
+  _agent_disconnect();
+
   // Delete session.
   libssh2_session_set_blocking(_session, 1);
   libssh2_session_disconnect(_session, "Centreon SSH Connector shutdown");
   libssh2_session_free(_session);
+  log::core()->debug(
+      "session {0}@{1}:{2} used up to {3} bytes ({4} bytes used by all "
+      "sessions)",
+      _creds.get_user(), _creds.get_host(), _creds.get_port(),
+      _allocator.get_peak(), allocator::get_total_allocated());
+}
+
+/**
+ *  Account a new check working with this session.
+ */
+void session::add_check() noexcept {
+  ++_checks_count;
 }
 
 /**
@@ -82,15 +114,20 @@ session::~session() noexcept {
  */
 void session::close() {
   // Unregister with multiplexer.
-  multiplexer::instance().handle_manager::remove(&_socket);
-  multiplexer::instance().handle_manager::remove(this);
+  multiplexer::instance().reactor::remove(&_socket);
+  multiplexer::instance().reactor::remove(this);
 
-  // Notify listeners.
+  // Notify listeners. They usually unregister from the session while
+  // being notified, so work on a copy of the list.
   {
-    for (auto& l : _listnrs)
+    std::set<listener*, by_deadline> listnrs(_listnrs);
+    for (auto& l : listnrs)
       l->on_close(*this);
   }
 
+  // The SFTP subsystem is bound to the connection.
+  _shutdown_sftp();
+
   // Close socket.
   _socket.close();
 }
@@ -208,7 +245,7 @@ void session::connect(bool use_ipv6) {
   _socket.set_native_handle(mysocket);
 
   // Register with multiplexer.
-  multiplexer::instance().handle_manager::add(&_socket, this, true);
+  multiplexer::instance().reactor::add(&_socket, this);
 
   // Launch the connection process.
   log::core()->debug(
@@ -242,6 +279,24 @@ void session::error([[maybe_unused]] handle& h) {
   this->close();
 }
 
+/**
+ *  Get the allocator serving libssh2 memory of this session.
+ *
+ *  @return Session allocator.
+ */
+allocator const& session::get_allocator() const noexcept {
+  return _allocator;
+}
+
+/**
+ *  Get the number of checks working with this session.
+ *
+ *  @return Number of checks in flight.
+ */
+unsigned int session::get_checks_count() const noexcept {
+  return _checks_count;
+}
+
 /**
  *  Get the session credentials.
  *
@@ -260,6 +315,39 @@ LIBSSH2_SESSION* session::get_libssh2_session() const noexcept {
   return _session;
 }
 
+/**
+ *  @brief Get the SFTP subsystem of the session.
+ *
+ *  The subsystem is opened on first use and then kept. libssh2 does
+ *  not support concurrent operations on a SFTP subsystem, so a single
+ *  listener uses it at a time until it calls release_sftp().
+ *
+ *  @param[in] listnr Listener requesting the subsystem.
+ *
+ *  @return SFTP subsystem, nullptr if it is used by another listener
+ *          or not yet opened. The listener will be notified again
+ *          when it can retry.
+ */
+LIBSSH2_SFTP* session::get_sftp(listener* listnr) {
+  if (_sftp_owner && _sftp_owner != listnr)
+    return nullptr;
+  _sftp_owner = listnr;
+  if (!_sftp) {
+    _sftp = libssh2_sftp_init(_session);
+    if (!_sftp) {
+      char* msg;
+      int ret(libssh2_session_last_error(_session, &msg, nullptr, 0));
+      if (ret != LIBSSH2_ERROR_EAGAIN) {
+        _sftp_owner = nullptr;
+        if (ret == LIBSSH2_ERROR_SOCKET_SEND)
+          error();
+        throw basic_error() << "could not open SFTP subsystem: " << msg;
+      }
+    }
+  }
+  return _sftp;
+}
+
 /**
  *  Get the socket handle.
  *
@@ -285,6 +373,7 @@ bool session::is_connected() const noexcept {
  */
 void session::listen(listener* listnr) {
   _listnrs.insert(listnr);
+  multiplexer::instance().reactor::update(&_socket);
 }
 
 /**
@@ -298,6 +387,7 @@ LIBSSH2_CHANNEL* session::new_channel() {
 
   // New channel flag.
   _needed_new_chan = true;
+  multiplexer::instance().reactor::update(&_socket);
 
   // Attempt to open channel.
   chan = libssh2_channel_open_session(_session);
@@ -324,8 +414,8 @@ LIBSSH2_CHANNEL* session::new_channel() {
  */
 void session::read([[maybe_unused]] handle& h) {
   static void (session::*const redirector[])() = {
-      &session::_startup, &session::_passwd, &session::_key,
-      &session::_available};
+      &session::_startup, &session::_passwd, &session::_agent,
+      &session::_key, &session::_available};
 
   try {
     (this->*redirector[_step])();
@@ -337,6 +427,33 @@ void session::read([[maybe_unused]] handle& h) {
   }
 }
 
+/**
+ *  Release the SFTP subsystem, another listener can use it.
+ *
+ *  @param[in] listnr Listener that used the subsystem.
+ */
+void session::release_sftp(listener* listnr) {
+  if (_sftp_owner != listnr)
+    return;
+  _sftp_owner = nullptr;
+
+  // Wake up listeners waiting for the subsystem, as when a new channel
+  // is requested.
+  _needed_new_chan = true;
+  multiplexer::instance().reactor::update(&_socket);
+}
+
+/**
+ *  Account the end of a check working with this session.
+ *
+ *  @return Number of checks still working with this session.
+ */
+unsigned int session::remove_check() noexcept {
+  if (_checks_count)
+    --_checks_count;
+  return _checks_count;
+}
+
 /**
  *  Remove a listener.
  *
@@ -351,6 +468,20 @@ void session::unlisten(listener* listnr) {
     _listnrs.erase(it);
   }
 
+  // A listener leaving in the middle of a SFTP operation leaves the
+  // subsystem in an unknown state, it is reopened on next use.
+  if (_sftp_owner == listnr) {
+    log::core()->info(
+        "SFTP operation interrupted on session {0}@{1}:{2}, closing SFTP "
+        "subsystem",
+        _creds.get_user(), _creds.get_host(), _creds.get_port());
+    _shutdown_sftp();
+    _needed_new_chan = true;
+  }
+
+  // The listener might have left the session waiting for the socket.
+  multiplexer::instance().reactor::update(&_socket);
+
   log::core()->debug(
       "session {0} removed listener {1} (there was {2}, there is {3})",
       static_cast<void*>(this), static_cast<void*>(listnr), size,
@@ -402,6 +533,155 @@ void session::write(handle& h) {
  *                                     *
  **************************************/
 
+/**
+ *  Attempt authentication with the identities of the ssh-agent, the
+ *  identity that last opened this destination first.
+ */
+void session::_agent() {
+  while (_agent_index < _agent_identities.size()) {
+    libssh2_agent_publickey* identity(_agent_identities[_agent_index]);
+    int retval(libssh2_agent_userauth(_agent_handle,
+                                      _creds.get_user().c_str(), identity));
+    if (retval == LIBSSH2_ERROR_EAGAIN)
+      return;
+    if (!retval) {
+      // Log message.
+      log::core()->info(
+          "successful agent-based authentication on session {0}@{1}:{2} "
+          "with identity {3}",
+          _creds.get_user(), _creds.get_host(), _creds.get_port(),
+          (identity->comment ? identity->comment : ""));
+
+      // Next connections to this destination will try it first, the
+      // agent is not needed anymore.
+      _agents->set_identity(
+          _creds, std::string(reinterpret_cast<char const*>(identity->blob),
+                              identity->blob_len));
+      _agent_disconnect();
+
+      // We're now connected.
+      _step = session_keepalive;
+      _step_string = "keep-alive";
+      {
+        for (auto& l : _listnrs)
+          l->on_connected(*this);
+      }
+      return;
+    }
+    log::core()->debug(
+        "ssh-agent identity {0} refused on session {1}@{2}:{3}",
+        (identity->comment ? identity->comment : ""), _creds.get_user(),
+        _creds.get_host(), _creds.get_port());
+    ++_agent_index;
+  }
+
+  // No identity was accepted, fall back to the key file.
+  log::core()->info(
+      "could not authenticate with ssh-agent on session {0}@{1}:{2}",
+      _creds.get_user(), _creds.get_host(), _creds.get_port());
+  _agents->forget(_creds);
+  _agent_disconnect();
+  _step = session_key;
+  _step_string = "public key authentication";
+  _key();
+}
+
+/**
+ *  Connect to the ssh-agent and fetch its identities. The agent
+ *  connection only lasts until authentication succeeds or falls back
+ *  to the key file, the agent cache keeps the identity that worked.
+ *
+ *  @return true if agent authentication can be attempted.
+ */
+bool session::_agent_connect() {
+  if (!_agents || !_agents->is_enabled())
+    return false;
+
+  // Connect to the agent. It is a local socket, blocking operations
+  // do not last.
+  if (!_agent_handle) {
+    _agent_handle = libssh2_agent_init(_session);
+    if (!_agent_handle) {
+      log::core()->error(
+          "could not create ssh-agent handle on session {0}@{1}:{2}",
+          _creds.get_user(), _creds.get_host(), _creds.get_port());
+      return false;
+    }
+#if LIBSSH2_VERSION_NUM >= 0x010900
+    libssh2_agent_set_identity_path(_agent_handle,
+                                    _agents->get_socket_path().c_str());
+#endif /* libssh2 version >= 1.9.0 */
+    if (libssh2_agent_connect(_agent_handle)) {
+      log::core()->error("could not connect to ssh-agent on {0}",
+                         _agents->get_socket_path());
+      _agent_disconnect();
+      return false;
+    }
+  }
+
+  // Fetch identities, the one known to open this destination first.
+  _agent_identities.clear();
+  _agent_index = 0;
+  if (libssh2_agent_list_identities(_agent_handle)) {
+    log::core()->error("could not list ssh-agent identities on {0}",
+                       _agents->get_socket_path());
+    _agent_disconnect();
+    return false;
+  }
+  std::string known(_agents->get_identity(_creds));
+  libssh2_agent_publickey* prev(nullptr);
+  libssh2_agent_publickey* identity(nullptr);
+  while (!libssh2_agent_get_identity(_agent_handle, &identity, prev)) {
+    if (!known.empty() && identity->blob_len == known.size() &&
+        !memcmp(identity->blob, known.data(), known.size()))
+      _agent_identities.insert(_agent_identities.begin(), identity);
+    else
+      _agent_identities.push_back(identity);
+    prev = identity;
+  }
+  if (_agent_identities.empty()) {
+    log::core()->info("ssh-agent on {0} holds no identity",
+                      _agents->get_socket_path());
+    return false;
+  }
+  log::core()->info(
+      "launching agent-based authentication on session {0}@{1}:{2} with {3} "
+      "identities",
+      _creds.get_user(), _creds.get_host(), _creds.get_port(),
+      _agent_identities.size());
+  return true;
+}
+
+/**
+ *  Disconnect from the ssh-agent.
+ */
+void session::_agent_disconnect() {
+  _agent_identities.clear();
+  _agent_index = 0;
+  if (_agent_handle) {
+    libssh2_agent_disconnect(_agent_handle);
+    libssh2_agent_free(_agent_handle);
+    _agent_handle = nullptr;
+  }
+}
+
+/**
+ *  Compare listeners by deadline, then by address.
+ *
+ *  @param[in] left  First listener.
+ *  @param[in] right Second listener.
+ *
+ *  @return true if left comes before right.
+ */
+bool session::by_deadline::operator()(listener const* left,
+                                      listener const* right) const {
+  if (left->get_deadline() < right->get_deadline())
+    return true;
+  if (right->get_deadline() < left->get_deadline())
+    return false;
+  return std::less<listener const*>()(left, right);
+}
+
 /**
  *  Session is available for operation.
  */
@@ -488,9 +768,15 @@ void session::_passwd() {
       log::core()->info(
           "could not authenticate with password on session {0}@{1}:{2}",
           _creds.get_user(), _creds.get_host(), _creds.get_port());
-      _step = session_key;
-      _step_string = "public key authentication";
-      _key();
+      if (_agent_connect()) {
+        _step = session_agent;
+        _step_string = "agent authentication";
+        _agent();
+      } else {
+        _step = session_key;
+        _step_string = "public key authentication";
+        _key();
+      }
     } else if (retval != LIBSSH2_ERROR_EAGAIN) {
       char* msg;
       libssh2_session_last_error(_session, &msg, nullptr, 0);
@@ -513,6 +799,19 @@ void session::_passwd() {
   }
 }
 
+/**
+ *  Close the SFTP subsystem (or at least try to).
+ */
+void session::_shutdown_sftp() {
+  if (_sftp) {
+    int ret(LIBSSH2_ERROR_EAGAIN);
+    for (unsigned int i = 0; (i < 32) && (ret == LIBSSH2_ERROR_EAGAIN); ++i)
+      ret = libssh2_sftp_shutdown(_sftp);
+    _sftp = nullptr;
+  }
+  _sftp_owner = nullptr;
+}
+
 /**
  *  Perform SSH connection startup.
  */
@@ -0,0 +1,110 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#include "com/centreon/connector/ssh/sessions/token_bucket.hh"
+
+#include <cmath>
+
+using namespace com::centreon::connector::ssh::sessions;
+
+/**************************************
+ *                                     *
+ *           Public Methods            *
+ *                                     *
+ **************************************/
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] rate  Tokens added per second, 0 for an unlimited bucket.
+ *  @param[in] burst Bucket capacity. If 0, capacity is set to rate.
+ */
+token_bucket::token_bucket(unsigned int rate, unsigned int burst)
+    : _burst(burst ? burst : rate),
+      _last(clock::now()),
+      _rate(rate),
+      _tokens(_burst) {}
+
+/**
+ *  Take one token from the bucket. Caller must have checked that a
+ *  token was available with wait_time().
+ */
+void token_bucket::consume() noexcept {
+  if (is_limited())
+    _tokens -= 1.0;
+}
+
+/**
+ *  Check if bucket is full, ie. it has not been used for a while.
+ *
+ *  @param[in] now Current time.
+ *
+ *  @return true if bucket is full.
+ */
+bool token_bucket::is_full(clock::time_point now) noexcept {
+  _refill(now);
+  return _tokens >= _burst;
+}
+
+/**
+ *  Check if bucket is limited.
+ *
+ *  @return true if bucket has a rate.
+ */
+bool token_bucket::is_limited() const noexcept {
+  return _rate > 0;
+}
+
+/**
+ *  Get the time to wait before a token is available.
+ *
+ *  @param[in] now Current time.
+ *
+ *  @return 0 if a token is available right now.
+ */
+std::chrono::milliseconds token_bucket::wait_time(
+    clock::time_point now) noexcept {
+  if (!is_limited())
+    return std::chrono::milliseconds(0);
+  _refill(now);
+  if (_tokens >= 1.0)
+    return std::chrono::milliseconds(0);
+  return std::chrono::milliseconds(
+      static_cast<long long>(std::ceil((1.0 - _tokens) * 1000.0 / _rate)));
+}
+
+/**************************************
+ *                                     *
+ *           Private Methods           *
+ *                                     *
+ **************************************/
+
+/**
+ *  Add tokens accumulated since last refill.
+ *
+ *  @param[in] now Current time.
+ */
+void token_bucket::_refill(clock::time_point now) noexcept {
+  if (now > _last) {
+    std::chrono::duration<double> elapsed(now - _last);
+    _tokens += elapsed.count() * _rate;
+    if (_tokens > _burst)
+      _tokens = _burst;
+    _last = now;
+  }
+}
@@ -0,0 +1,298 @@
+/*
+** Copyright 2021 Centreon
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+** For more information : contact@centreon.com
+*/
+
+#include "com/centreon/connector/ssh/worker.hh"
+
+#include <vector>
+
+#include "com/centreon/connector/log.hh"
+#include "com/centreon/connector/ssh/checks/check.hh"
+#include "com/centreon/connector/ssh/multiplexer.hh"
+#include "com/centreon/connector/ssh/sessions/connect_queue.hh"
+#include "com/centreon/connector/ssh/sessions/session.hh"
+#include "com/centreon/delayed_delete.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::connector;
+using namespace com::centreon::connector::ssh;
+
+/**************************************
+ *                                     *
+ *           Public Methods            *
+ *                                     *
+ **************************************/
+
+/**
+ *  Constructor. The worker thread is started immediately.
+ *
+ *  @param[in] id               Worker ID, used in logs.
+ *  @param[in] limiter          Handshake limiter shared by all workers.
+ *  @param[in] agents           ssh-agent identity cache shared by all
+ *                              workers.
+ *  @param[in] max_output_size  Maximum size of each check output
+ *                              stream, 0 for no limit.
+ *  @param[in] results          Queue where check results are sent.
+ *  @param[in] results_notifier Notified when results are queued.
+ */
+worker::worker(unsigned int id,
+               sessions::handshake_limiter& limiter,
+               sessions::agent_cache& agents,
+               size_t max_output_size,
+               mpsc_queue<checks::result>& results,
+               notifier& results_notifier)
+    : _agents(agents),
+      _id(id),
+      _limiter(limiter),
+      _max_output_size(max_output_size),
+      _notifier([this]() { _process_orders(); }),
+      _results(results),
+      _results_notifier(results_notifier),
+      _failed(false),
+      _should_exit(false) {
+  _thread = std::thread(&worker::_run, this);
+}
+
+/**
+ *  Destructor. Stop the worker thread and wait for its termination.
+ */
+worker::~worker() noexcept {
+  try {
+    _should_exit = true;
+    _notifier.notify();
+    if (_thread.joinable())
+      _thread.join();
+  } catch (...) {
+  }
+}
+
+/**
+ *  Queue a check for execution by this worker. Can be called from any
+ *  thread.
+ *
+ *  @param[in] o Check execution order.
+ */
+void worker::execute(order&& o) {
+  if (_orders.push(std::move(o)))
+    _notifier.notify();
+}
+
+/**
+ *  Check whether the worker thread stopped because of an error. Can be
+ *  called from any thread.
+ *
+ *  @return true if the worker failed.
+ */
+bool worker::has_failed() const noexcept {
+  return _failed;
+}
+
+/**
+ *  Check result has arrived.
+ *
+ *  @param[in] r Check result.
+ */
+void worker::on_result(checks::result& r) {
+  // Remove check from list.
+  auto chk = _checks.find(r.get_command_id());
+  if (chk == _checks.end())
+    log::core()->error("got result of check {} which is not registered",
+                       r.get_command_id());
+  else {
+    try {
+      chk->second.first->unlisten(this);
+      chk->second.second->unlisten(chk->second.first);
+    } catch (...) {
+    }
+    delete chk->second.first;
+    sessions::session* sess(chk->second.second);
+    _checks.erase(chk);
+
+    // Check session.
+    if (!sess->remove_check() && !sess->is_connected()) {
+      auto it = _sessions.find(sess->get_credentials());
+      if (it == _sessions.end() || it->second != sess)
+        log::core()->error(
+            "session {} was not found in worker list, deleting anyway",
+            static_cast<void*>(sess));
+      else {
+        log::core()->info(
+            "session {0}@{1}:{2} that is not connected and has no check "
+            "running will be deleted",
+            it->first.get_user(), it->first.get_host(), it->first.get_port());
+        _sessions.erase(it);
+      }
+      _connect_queue->cancel(sess);
+      delayed_delete<sessions::session>* dd =
+          new delayed_delete<sessions::session>(sess);
+      multiplexer::instance().task_manager::add(dd, 0, false, true);
+    }
+  }
+
+  // Send check result back to policy.
+  if (_results.push(std::move(r)))
+    _results_notifier.notify();
+}
+
+/**************************************
+ *                                     *
+ *           Private Methods           *
+ *                                     *
+ **************************************/
+
+/**
+ *  Close all checks and sessions of this worker.
+ */
+void worker::_cleanup() {
+  // Close checks.
+  for (auto& c : _checks) {
+    try {
+      c.second.first->unlisten(this);
+    } catch (...) {
+    }
+    delete c.second.first;
+  }
+  _checks.clear();
+
+  // Close sessions.
+  for (auto& s : _sessions) {
+    if (_connect_queue)
+      _connect_queue->cancel(s.second);
+    try {
+      s.second->close();
+    } catch (...) {
+    }
+    delete s.second;
+  }
+  _sessions.clear();
+}
+
+/**
+ *  Start executing a check.
+ *
+ *  @param[in] o Check execution order.
+ */
+void worker::_execute(order& o) {
+  try {
+    // Find session. New sessions are connected once the check is
+    // registered, the handshake limiter might delay them.
+    bool is_new(false);
+    auto it = _sessions.find(o.creds);
+    if (it == _sessions.end()) {
+      log::core()->info("creating session for {0}@{1}:{2} in worker {3}",
+                        o.creds.get_user(), o.creds.get_host(),
+                        o.creds.get_port(), _id);
+      std::unique_ptr<sessions::session> sess{
+          new sessions::session(o.creds, &_agents)};
+      it = _sessions.emplace(o.creds, sess.get()).first;
+      sess.release();
+      is_new = true;
+    }
+
+    sessions::session* sess = it->second;
+
+    // Create check object.
+    checks::check* chk_ptr = new checks::check(
+        o.skip_stdout, o.skip_stderr, _max_output_size, o.use_builtin);
+    chk_ptr->listen(this);
+    _checks[o.cmd_id] = std::make_pair(chk_ptr, sess);
+    sess->add_check();
+
+    chk_ptr->execute(*sess, o.cmd_id, o.cmds, o.timeout);
+    if (is_new)
+      _connect_queue->connect(sess, o.use_ipv6, o.timeout);
+  } catch (std::exception const& e) {
+    log::core()->error(
+        "could not launch check ID {0} on host {1} because an error occurred: "
+        "{2}",
+        o.cmd_id, o.creds.get_host(), e.what());
+    checks::result r;
+    r.set_command_id(o.cmd_id);
+    r.set_error(e.what());
+    on_result(r);
+  } catch (...) {
+    log::core()->error(
+        "could not launch check ID {0} on host {1} because an error occurred",
+        o.cmd_id, o.creds.get_host());
+    checks::result r;
+    r.set_command_id(o.cmd_id);
+    on_result(r);
+  }
+}
+
+/**
+ *  Execute queued orders. Orders whose deadline already passed are
+ *  answered as timed out without touching the network. Checks then
+ *  wait for channels earliest deadline first, see sessions::listener.
+ */
+void worker::_process_orders() {
+  std::vector<order> orders;
+  _orders.consume([&orders](order&& o) { orders.push_back(std::move(o)); });
+
+  timestamp now(timestamp::now());
+  for (order& o : orders) {
+    if (o.timeout <= now) {
+      log::core()->warn("check {0} expired before worker {1} could start it",
+                        o.cmd_id, _id);
+      checks::result r;
+      r.set_command_id(o.cmd_id);
+      r.set_error("check expired before it could be started");
+      if (_results.push(std::move(r)))
+        _results_notifier.notify();
+    } else
+      _execute(o);
+  }
+}
+
+/**
+ *  Worker thread entry point.
+ */
+void worker::_run() {
+  log::core()->info("worker {} starting", _id);
+  try {
+    multiplexer::load();
+    _connect_queue.reset(new sessions::connect_queue(_limiter));
+    multiplexer::instance().reactor::add(&_notifier, &_notifier);
+
+    // Orders might have been queued before the notifier was registered.
+    _process_orders();
+    while (!_should_exit)
+      multiplexer::instance().multiplex();
+  } catch (std::exception const& e) {
+    log::core()->error("worker {0} stopped because of an error: {1}", _id,
+                       e.what());
+    _failed = true;
+  } catch (...) {
+    log::core()->error("worker {} stopped because of an unknown error", _id);
+    _failed = true;
+  }
+
+  // Wake the policy up, it stops the connector.
+  if (_failed)
+    _results_notifier.notify();
+
+  // Release everything that depends on this thread's multiplexer.
+  try {
+    _cleanup();
+    multiplexer::instance().reactor::remove(
+        static_cast<com::centreon::handle*>(&_notifier));
+  } catch (...) {
+  }
+  _connect_queue.reset();
+  multiplexer::unload();
+  log::core()->info("worker {} stopped", _id);
+}
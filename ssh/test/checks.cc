@@ -19,7 +19,10 @@
 
 #include <gtest/gtest.h>
 
+#include "com/centreon/connector/ssh/checks/batch.hh"
+#include "com/centreon/connector/ssh/checks/builtin.hh"
 #include "com/centreon/connector/ssh/checks/check.hh"
+#include "com/centreon/connector/ssh/checks/output_filter.hh"
 #include "com/centreon/connector/ssh/checks/result.hh"
 #include "com/centreon/connector/ssh/checks/timeout.hh"
 
@@ -59,6 +62,113 @@ TEST(SSHChecks, ResultAssign) {
             "another random string, but for the output property");
 }
 
+TEST(SSHChecks, Batch) {
+  // Object.
+  batch b(100, {"node1", "node2", "node3"});
+  ASSERT_EQ(b.get_command_id(), 100);
+  ASSERT_FALSE(b.is_complete());
+
+  // Results of hosts, in any order.
+  result r;
+  r.set_executed(true);
+  r.set_exit_code(1);
+  r.set_output("WARNING - load 5\nmore details");
+  ASSERT_TRUE(b.add(2, r));
+  ASSERT_FALSE(b.add(2, r));
+  r.set_exit_code(0);
+  r.set_output("OK - load 0");
+  ASSERT_TRUE(b.add(0, r));
+  ASSERT_FALSE(b.add(3, r));
+  ASSERT_FALSE(b.is_complete());
+  result failed;
+  failed.set_error("connection refused");
+  ASSERT_TRUE(b.add(1, failed));
+  ASSERT_TRUE(b.is_complete());
+
+  // Worst state wins, unknown is worse than warning.
+  result aggregated(b.get_result());
+  ASSERT_EQ(aggregated.get_command_id(), 100);
+  ASSERT_TRUE(aggregated.get_executed());
+  ASSERT_EQ(aggregated.get_exit_code(), 3);
+  ASSERT_EQ(aggregated.get_output(),
+            "3 hosts: 1 OK, 1 WARNING, 0 CRITICAL, 1 UNKNOWN\n"
+            "node1: OK - load 0\n"
+            "node2: (not executed) connection refused\n"
+            "node3: WARNING - load 5");
+  ASSERT_EQ(aggregated.get_error(), "node2: connection refused");
+}
+
+TEST(SSHChecks, BuiltinParse) {
+  // Valid primitives.
+  builtin age("file-age /var/log/messages 300 600");
+  ASSERT_EQ(age.get_type(), builtin::file_age);
+  ASSERT_EQ(age.get_path(), "/var/log/messages");
+  ASSERT_FALSE(age.needs_content());
+  builtin count("regex-count /var/log/messages \"error|fail\"");
+  ASSERT_EQ(count.get_type(), builtin::regex_count);
+  ASSERT_TRUE(count.needs_content());
+
+  // Invalid ones.
+  ASSERT_THROW(builtin("uptime"), std::exception);
+  ASSERT_THROW(builtin("file-size"), std::exception);
+  ASSERT_THROW(builtin("file-size /tmp 1 2 3"), std::exception);
+  ASSERT_THROW(builtin("file-size /tmp ten"), std::exception);
+  ASSERT_THROW(builtin("regex-count /tmp ("), std::exception);
+}
+
+TEST(SSHChecks, BuiltinFileAge) {
+  builtin b("file-age /var/log/messages 300 600");
+  result r(b.evaluate(0, 1000, "", 1400));
+  ASSERT_TRUE(r.get_executed());
+  ASSERT_EQ(r.get_exit_code(), 1);
+  ASSERT_EQ(r.get_output(),
+            "FILE_AGE WARNING - /var/log/messages is 400 s old"
+            "|age=400s;300;600");
+  ASSERT_EQ(b.evaluate(0, 1000, "", 1700).get_exit_code(), 2);
+  ASSERT_EQ(b.evaluate(0, 1000, "", 900).get_exit_code(), 0);
+}
+
+TEST(SSHChecks, BuiltinFileSize) {
+  builtin b("file-size /var/lib/db 1000000000");
+  result r(b.evaluate(1234567890, 0, "", 0));
+  ASSERT_EQ(r.get_exit_code(), 1);
+  ASSERT_EQ(r.get_output(),
+            "FILE_SIZE WARNING - /var/lib/db is 1234567890 bytes"
+            "|size=1234567890B;1000000000;");
+}
+
+TEST(SSHChecks, BuiltinProcFile) {
+  builtin load("proc-file /proc/loadavg 2 4 8");
+  result r(load.evaluate(0, 0, "0.52 4.5 9.25 1/123 4567\n", 0));
+  ASSERT_EQ(r.get_exit_code(), 1);
+  ASSERT_EQ(r.get_output(),
+            "PROC_FILE WARNING - 2 of /proc/loadavg is 4.5|value=4.5;4;8");
+  ASSERT_EQ(load.evaluate(0, 0, "0.52\n", 0).get_exit_code(), 3);
+
+  builtin mem("proc-file /proc/meminfo MemAvailable");
+  char const* meminfo =
+      "MemTotal:        8000000 kB\n"
+      "MemFree:          100000 kB\n"
+      "MemAvailable:    2000000 kB\n";
+  r = mem.evaluate(0, 0, meminfo, 0);
+  ASSERT_EQ(r.get_exit_code(), 0);
+  ASSERT_EQ(r.get_output(),
+            "PROC_FILE OK - MemAvailable of /proc/meminfo is 2000000"
+            "|value=2000000;;");
+  ASSERT_EQ(mem.evaluate(0, 0, "MemTotal: 1 kB\n", 0).get_exit_code(), 3);
+}
+
+TEST(SSHChecks, BuiltinRegexCount) {
+  builtin b("regex-count /var/log/app.log \"(error|fail)\" 0 2");
+  result r(b.evaluate(0, 0, "ok\nerror 1\nfine\nfailed twice\nerror 3", 0));
+  ASSERT_EQ(r.get_exit_code(), 2);
+  ASSERT_EQ(r.get_output(),
+            "REGEX_COUNT CRITICAL - 3 lines of /var/log/app.log match "
+            "'(error|fail)'|count=3;0;2");
+  ASSERT_EQ(b.make_result(2, "gone").get_output(),
+            "REGEX_COUNT CRITICAL - gone");
+}
+
 TEST(SSHChecks, CommandId) {
   // Object.
   com::centreon::connector::ssh::checks::result r;
@@ -107,6 +217,30 @@ TEST(SSHChecks, CtorCopy) {
             "another random string, but for the output property");
 }
 
+TEST(SSHChecks, CtorMove) {
+  // Base object.
+  std::string output(4096, 'o');
+  result r1;
+  r1.set_command_id(14598753ull);
+  r1.set_error(std::string("a random error string"));
+  r1.set_executed(true);
+  r1.set_exit_code(-46582);
+  r1.set_output(std::move(output));
+
+  // Moved object.
+  result r2(std::move(r1));
+  result r3;
+  r3 = std::move(r2);
+
+  // Check content.
+  ASSERT_TRUE(output.empty());
+  ASSERT_EQ(r3.get_command_id(), 14598753ull);
+  ASSERT_EQ(r3.get_error(), "a random error string");
+  ASSERT_EQ(r3.get_executed(), true);
+  ASSERT_EQ(r3.get_exit_code(), -46582);
+  ASSERT_EQ(r3.get_output(), std::string(4096, 'o'));
+}
+
 TEST(SSHChecks, CtorDefault) {
   // Object.
   com::centreon::connector::ssh::checks::result r;
@@ -167,6 +301,54 @@ TEST(SSHChecks, ExitCode) {
     ASSERT_EQ(r.get_exit_code(), -47829);
 }
 
+TEST(SSHChecks, OutputFilterAll) {
+  // Object.
+  output_filter of;
+  of.append("line1\nline2\n", 12);
+  of.append("line3", 5);
+
+  // Checks.
+  ASSERT_FALSE(of.is_full());
+  ASSERT_EQ(of.get_data(), "line1\nline2\nline3");
+}
+
+TEST(SSHChecks, OutputFilterNone) {
+  // Object.
+  output_filter of(0);
+  of.append("line1\nline2\n", 12);
+
+  // Checks.
+  ASSERT_TRUE(of.is_full());
+  ASSERT_TRUE(of.get_data().empty());
+}
+
+TEST(SSHChecks, OutputFilterLines) {
+  // Object.
+  output_filter of(2);
+  of.append("\nline1", 6);
+  of.append("\nli", 3);
+  of.append("ne2\nline3\nline4", 15);
+
+  // Checks.
+  ASSERT_TRUE(of.is_full());
+  ASSERT_EQ(of.release(), "\nline1\nline2");
+  ASSERT_TRUE(of.get_data().empty());
+}
+
+TEST(SSHChecks, OutputFilterSize) {
+  // Object.
+  output_filter of(-1, 8);
+  of.append("line1\n", 6);
+  of.append("line2\n", 6);
+  of.append("line3\n", 6);
+
+  // Checks.
+  ASSERT_TRUE(of.is_full());
+  ASSERT_TRUE(of.is_truncated());
+  ASSERT_EQ(of.get_data(), "line1\nli");
+  ASSERT_EQ(of.release(), "line1\nli\n(output truncated)");
+}
+
 TEST(SSHChecks, Output) {
   // Object.
   com::centreon::connector::ssh::checks::result r;
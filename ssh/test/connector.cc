@@ -15,4 +15,115 @@
  *
  * For more information : contact@centreon.com
  *
- */
\ No newline at end of file
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "com/centreon/process.hh"
+
+using namespace com::centreon;
+static std::string ssh_connector = BUILD_PATH "/ssh/centreon_connector_ssh";
+
+class TestSSHConnector : public testing::Test {
+ public:
+  TestSSHConnector() : testing::Test(), p(nullptr, true, true, false) {}
+
+  /**
+   *  Build the header of an execution order. Orders are started long
+   *  ago, their checks are answered as timed out without touching the
+   *  network.
+   */
+  static std::string header(char const* type, char const* cmd_id) {
+    std::string retval(type);
+    retval.append(1, '\0').append(cmd_id).append(1, '\0');
+    retval.append("5").append(1, '\0');
+    retval.append(std::to_string(time(nullptr) - 100)).append(1, '\0');
+    return retval;
+  }
+
+  static std::string execute(char const* cmd_id) {
+    return header("2", cmd_id)
+        .append(
+            "check_by_ssh -H nonexistenthost.nonexistentdomain -C 'echo "
+            "Centreon is wonderful'")
+        .append(4, '\0');
+  }
+
+  static std::string execute_many(char const* cmd_id, char const* hosts) {
+    return header("6", cmd_id)
+        .append(hosts)
+        .append(1, '\0')
+        .append("check_by_ssh -C 'echo Centreon is wonderful'")
+        .append(4, '\0');
+  }
+
+  /**
+   *  Run the connector with some orders.
+   *
+   *  @return Command IDs and outputs of results.
+   */
+  std::vector<std::pair<std::string, std::string> > run(
+      std::string const& orders) {
+    p.exec(ssh_connector);
+    char const* ptr(orders.c_str());
+    unsigned int size(orders.size());
+    while (size > 0) {
+      unsigned int rb(p.write(ptr, size));
+      size -= rb;
+      ptr += rb;
+    }
+    p.update_ending_process(0);
+
+    std::string output;
+    while (true) {
+      std::string buffer;
+      p.read(buffer);
+      if (buffer.empty())
+        break;
+      output.append(buffer);
+    }
+    if (!p.wait(5000)) {
+      p.terminate();
+      p.wait();
+    }
+
+    // Results are made of type, ID, executed, exit code, error and
+    // output.
+    std::vector<std::pair<std::string, std::string> > retval;
+    for (size_t pos(0), end; (end = output.find(std::string(4, '\0'), pos)) !=
+                             std::string::npos;
+         pos = end + 4) {
+      std::vector<std::string> fields;
+      for (size_t first(pos); first <= end;) {
+        size_t last(output.find('\0', first));
+        fields.push_back(output.substr(first, last - first));
+        first = last + 1;
+      }
+      if (fields.size() == 6 && fields[0] == "3")
+        retval.emplace_back(fields[1], fields[5]);
+    }
+    return retval;
+  }
+
+ protected:
+  process p;
+};
+
+TEST_F(TestSSHConnector, FanOutIds) {
+  // The fan-out order is followed by an order using the next ID.
+  auto results(run(execute_many("10",
+                                "nonexistenthost1.nonexistentdomain,"
+                                "nonexistenthost2.nonexistentdomain") +
+                   execute("11")));
+
+  // A single aggregated result and the result of the ordinary order.
+  ASSERT_EQ(results.size(), 2u);
+  std::sort(results.begin(), results.end());
+  ASSERT_EQ(results[0].first, "10");
+  ASSERT_EQ(results[0].second.substr(0, 8), "2 hosts:");
+  ASSERT_EQ(results[1].first, "11");
+}
@@ -75,6 +75,8 @@ void fake_listener::on_error(uint64_t cmd_id, char const* msg) {
  *  @param[in] skip_stdout Should stdout be skipped.
  *  @param[in] skip_stderr Should stderr be skipped.
  *  @param[in] is_ipv6     Work with IPv6.
+ *  @param[in] compress    Compress SSH transport.
+ *  @param[in] builtin     Commands are built-in checks.
  */
 void fake_listener::on_execute(uint64_t cmd_id,
                                const timestamp& timeout,
@@ -86,7 +88,9 @@ void fake_listener::on_execute(uint64_t cmd_id,
                                std::list<std::string> const& cmds,
                                int skip_stdout,
                                int skip_stderr,
-                               bool is_ipv6) {
+                               bool is_ipv6,
+                               bool compress,
+                               bool builtin) {
   callback_info ci;
   ci.callback = cb_execute;
   ci.cmd_id = cmd_id;
@@ -100,9 +104,48 @@ void fake_listener::on_execute(uint64_t cmd_id,
   ci.skip_stdout = skip_stdout;
   ci.skip_stderr = skip_stderr;
   ci.is_ipv6 = is_ipv6;
+  ci.compress = compress;
+  ci.builtin = builtin;
   _callbacks.push_back(ci);
 }
 
+/**
+ *  Fan-out execute callback.
+ *
+ *  @param[in] cmd_id      First command ID.
+ *  @param[in] timeout     Timeout.
+ *  @param[in] hosts       Hosts.
+ *  @param[in] port        Connection port.
+ *  @param[in] user        User.
+ *  @param[in] password    Password.
+ *  @param[in] identity    Identity file.
+ *  @param[in] cmds        Commands.
+ *  @param[in] skip_stdout Should stdout be skipped.
+ *  @param[in] skip_stderr Should stderr be skipped.
+ *  @param[in] is_ipv6     Work with IPv6.
+ *  @param[in] compress    Compress SSH transport.
+ *  @param[in] builtin     Commands are built-in checks.
+ */
+void fake_listener::on_execute_many(uint64_t cmd_id,
+                                    const timestamp& timeout,
+                                    std::vector<std::string> const& hosts,
+                                    unsigned short port,
+                                    std::string const& user,
+                                    std::string const& password,
+                                    std::string const& identity,
+                                    std::list<std::string> const& cmds,
+                                    int skip_stdout,
+                                    int skip_stderr,
+                                    bool is_ipv6,
+                                    bool compress,
+                                    bool builtin) {
+  on_execute(cmd_id, timeout, "", port, user, password, identity, cmds,
+             skip_stdout, skip_stderr, is_ipv6, compress, builtin);
+  callback_info& ci(_callbacks.back());
+  ci.callback = cb_execute_many;
+  ci.hosts = hosts;
+}
+
 /**
  *  Quit callback.
  */
@@ -144,7 +187,8 @@ bool operator==(std::list<fake_listener::callback_info> const& left,
     for (auto it1 = left.begin(), end1 = left.end(), it2 = right.begin();
          it1 != end1; ++it1, ++it2)
       if ((it1->callback != it2->callback) ||
-          ((it1->callback == fake_listener::cb_execute) &&
+          (((it1->callback == fake_listener::cb_execute) ||
+            (it1->callback == fake_listener::cb_execute_many)) &&
            ((it1->cmd_id != it2->cmd_id) ||
             (fabs(it1->timeout.to_seconds() - it2->timeout.to_seconds()) >=
              1.0) ||
@@ -153,7 +197,10 @@ bool operator==(std::list<fake_listener::callback_info> const& left,
             (it1->identity != it2->identity) ||
             (it1->skip_stdout != it2->skip_stdout) ||
             (it1->skip_stderr != it2->skip_stderr) ||
-            (it1->is_ipv6 != it2->is_ipv6) || (it1->cmds != it2->cmds))))
+            (it1->is_ipv6 != it2->is_ipv6) ||
+            (it1->compress != it2->compress) ||
+            (it1->builtin != it2->builtin) ||
+            (it1->hosts != it2->hosts) || (it1->cmds != it2->cmds))))
         retval = false;
   }
   return retval;
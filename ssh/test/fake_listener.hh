@@ -20,6 +20,7 @@
 #define TEST_ORDERS_FAKE_LISTENER_HH
 
 #include <list>
+#include <vector>
 #include "com/centreon/connector/ssh/orders/listener.hh"
 #include "com/centreon/timestamp.hh"
 
@@ -37,6 +38,7 @@ class fake_listener : public com::centreon::connector::ssh::orders::listener {
     cb_eof,
     cb_error,
     cb_execute,
+    cb_execute_many,
     cb_quit,
     cb_version
   };
@@ -45,6 +47,7 @@ class fake_listener : public com::centreon::connector::ssh::orders::listener {
     uint64_t cmd_id;
     timestamp timeout;
     std::string host;
+    std::vector<std::string> hosts;
     unsigned short port;
     std::string user;
     std::string password;
@@ -53,6 +56,8 @@ class fake_listener : public com::centreon::connector::ssh::orders::listener {
     int skip_stderr;
     int skip_stdout;
     bool is_ipv6;
+    bool compress = false;
+    bool builtin = false;
   };
 
   fake_listener() = default;
@@ -72,7 +77,22 @@ class fake_listener : public com::centreon::connector::ssh::orders::listener {
                   std::list<std::string> const& cmds,
                   int skip_stdout,
                   int skip_stderr,
-                  bool is_ipv6) override;
+                  bool is_ipv6,
+                  bool compress,
+                  bool builtin) override;
+  void on_execute_many(uint64_t cmd_id,
+                       const timestamp& timeout,
+                       std::vector<std::string> const& hosts,
+                       unsigned short port,
+                       std::string const& user,
+                       std::string const& password,
+                       std::string const& identity,
+                       std::list<std::string> const& cmds,
+                       int skip_stdout,
+                       int skip_stderr,
+                       bool is_ipv6,
+                       bool compress,
+                       bool builtin) override;
   void on_quit() override;
   void on_version() override;
 
@@ -106,8 +106,9 @@ TEST(SSHOrders, Execute) {
   bh.write(str, strlen(str) + 1);
   str = "4242";  // Timeout.
   bh.write(str, strlen(str) + 1);
-  str = "4241";  // Start time.
-  bh.write(str, strlen(str) + 1);
+  time_t now(time(nullptr));
+  std::string start_time(std::to_string(now));  // Start time.
+  bh.write(start_time.c_str(), start_time.size() + 1);
   str =
       "check_by_ssh -H localhost -l root -a myverysecretpassword -C \"mycheck "
       "to execute with some args\"";
@@ -127,7 +128,7 @@ TEST(SSHOrders, Execute) {
   // Listener must have received execute and eof.
   ASSERT_EQ(listnr.get_callbacks().size(), 2);
   fake_listener::callback_info info1, info2;
-  timestamp comparison_timeout(timestamp::now() + 4242);
+  timestamp comparison_timeout(now + 4242);
   info1 = *listnr.get_callbacks().begin();
   info2 = *++listnr.get_callbacks().begin();
   std::cout << "order ID:   " << fake_listener::cb_execute << std::endl
@@ -162,6 +163,85 @@ TEST(SSHOrders, Execute) {
   ASSERT_TRUE(p.get_buffer().empty());
 }
 
+const char ExecuteMany_CMD[] =
+    "6\00042\00030\0001478523690\0node1,node2,,node3\0check_by_ssh -l "
+    "root -i /root/.ssh/id_rsa -C uptime\0\0\0\0"
+    "6\00050\00030\0001478523690\0,,\0check_by_ssh -C uptime\0\0\0\0"
+    "6\00060\00030\0001478523690\0node1\0check_by_ssh\0\0\0\0";
+
+TEST(SSHOrders, ExecuteMany) {
+  // Create fan-out order packets, the last two are invalid.
+  buffer_handle bh;
+  bh.write(ExecuteMany_CMD, sizeof(ExecuteMany_CMD) - 1);
+
+  // Listener.
+  fake_listener listnr;
+
+  // Parser.
+  parser p;
+  p.listen(&listnr);
+  while (!bh.empty())
+    p.read(bh);
+  p.read(bh);
+
+  // Listener must have received one order, two errors and eof.
+  ASSERT_EQ(listnr.get_callbacks().size(), 4);
+  std::list<fake_listener::callback_info>::const_iterator it(
+      listnr.get_callbacks().begin());
+  fake_listener::callback_info info(*(it++));
+  ASSERT_EQ(info.callback, fake_listener::cb_execute_many);
+  ASSERT_EQ(info.cmd_id, 42);
+  ASSERT_EQ(info.hosts, std::vector<std::string>({"node1", "node2", "node3"}));
+  ASSERT_EQ(info.user, "root");
+  ASSERT_EQ(info.identity, "/root/.ssh/id_rsa");
+  ASSERT_EQ(info.cmds.size(), 1);
+  ASSERT_EQ(info.cmds.front(), "uptime");
+  ASSERT_EQ((it++)->callback, fake_listener::cb_error);
+  ASSERT_EQ((it++)->callback, fake_listener::cb_error);
+  ASSERT_EQ((it++)->callback, fake_listener::cb_eof);
+
+  // Parser must be empty.
+  ASSERT_TRUE(p.get_buffer().empty());
+}
+
+TEST(SSHOrders, ExecuteDeadline) {
+  // Orders started 100 seconds ago with a 30 seconds timeout and
+  // started in the future.
+  std::string past(std::to_string(time(nullptr) - 100));
+  std::string future(std::to_string(time(nullptr) + 1000));
+  char const header1[] = "2\0" "1\0" "30\0";
+  char const header2[] = "2\0" "2\0" "30\0";
+  char const cmdline[] = "\0check_by_ssh -H localhost -C ls\0\0\0\0";
+  std::string orders;
+  orders.append(header1, sizeof(header1) - 1)
+      .append(past)
+      .append(cmdline, sizeof(cmdline) - 1)
+      .append(header2, sizeof(header2) - 1)
+      .append(future)
+      .append(cmdline, sizeof(cmdline) - 1);
+  buffer_handle bh;
+  bh.write(orders.c_str(), orders.size());
+
+  // Listener.
+  fake_listener listnr;
+
+  // Parser.
+  parser p;
+  p.listen(&listnr);
+  while (!bh.empty())
+    p.read(bh);
+  p.read(bh);
+
+  // Deadlines run from the start time, unless it is in the future.
+  ASSERT_EQ(listnr.get_callbacks().size(), 3);
+  fake_listener::callback_info info1(*listnr.get_callbacks().begin());
+  fake_listener::callback_info info2(*++listnr.get_callbacks().begin());
+  ASSERT_EQ(info1.callback, fake_listener::cb_execute);
+  ASSERT_LE(std::abs(info1.timeout.to_seconds() - (time(nullptr) - 70)), 1);
+  ASSERT_EQ(info2.callback, fake_listener::cb_execute);
+  ASSERT_LE(std::abs(info2.timeout.to_seconds() - (time(nullptr) + 30)), 1);
+}
+
 TEST(SSHOrders, ExecuteInvalidId) {
   // Create invalid execute order packet.
   buffer_handle bh;
@@ -197,6 +277,30 @@ TEST(SSHOrders, ExecuteInvalidId) {
   ASSERT_TRUE(p.get_buffer().empty());
 }
 
+TEST(SSHOrders, ExecuteReservedId) {
+  // Command IDs from 2^63 are reserved for fan-out hosts.
+  char const order[] =
+      "2\0009223372036854775808\00030\0001478523690\0"
+      "check_by_ssh -H localhost -C ls\0\0\0\0";
+  buffer_handle bh;
+  bh.write(order, sizeof(order) - 1);
+
+  // Listener.
+  fake_listener listnr;
+
+  // Parser.
+  parser p;
+  p.listen(&listnr);
+  while (!bh.empty())
+    p.read(bh);
+  p.read(bh);
+
+  // Listener must have received an error and eof.
+  ASSERT_EQ(listnr.get_callbacks().size(), 2);
+  ASSERT_EQ(listnr.get_callbacks().front().callback, fake_listener::cb_error);
+  ASSERT_EQ(listnr.get_callbacks().back().callback, fake_listener::cb_eof);
+}
+
 TEST(SSHOrders, ExecuteInvalidStartTime) {
   // Create invalid execute order packet.
   buffer_handle bh;
@@ -389,9 +493,10 @@ const char Suite_CMD[] =
     "2\000147852\0007849\000147852369\0check_by_ssh -H localhost -l root -a "
     "password -6 -C ls\0\0\0\0"
     "2\00036525825445548787\0002258\00001\0check_by_ssh -H www.merethis.com -l "
-    "centreon -a iswonderful -C \"rm -rf /\"\0\0\0\0"
+    "centreon -a iswonderful --compress -C \"rm -rf /\"\0\0\0\0"
     "2\00063\0000\00099999999999999999\000check_by_ssh -H www.centreon.com -p "
-    "2222 -l merethis -a rocks -C \"./check_for_updates on website\"\0\0\0\0"
+    "2222 -l merethis -a rocks --builtin -C \"file-age /var/log/messages\""
+    "\0\0\0\0"
     "4\0\0\0\0";
 
 /**
@@ -425,7 +530,7 @@ TEST(SSHOrders, Suite) {
     fake_listener::callback_info execute;
     execute.callback = fake_listener::cb_execute;
     execute.cmd_id = 147852;
-    execute.timeout = 7849 + time(nullptr);
+    execute.timeout = 7849 + 147852369;
     execute.host = "localhost";
     execute.port = 22;
     execute.user = "root";
@@ -440,7 +545,7 @@ TEST(SSHOrders, Suite) {
     fake_listener::callback_info execute;
     execute.callback = fake_listener::cb_execute;
     execute.cmd_id = 36525825445548787ull;
-    execute.timeout = 2258 + time(nullptr);
+    execute.timeout = 2258 + 1;
     execute.host = "www.merethis.com";
     execute.port = 22;
     execute.user = "centreon";
@@ -449,6 +554,7 @@ TEST(SSHOrders, Suite) {
     execute.skip_stdout = -1;
     execute.skip_stderr = -1;
     execute.is_ipv6 = false;
+    execute.compress = true;
     expected.push_back(execute);
   }
   {  // Third execution order.
@@ -460,10 +566,11 @@ TEST(SSHOrders, Suite) {
     execute.port = 2222;
     execute.user = "merethis";
     execute.password = "rocks";
-    execute.cmds.emplace_back("./check_for_updates on website");
+    execute.cmds.emplace_back("file-age /var/log/messages");
     execute.skip_stdout = -1;
     execute.skip_stderr = -1;
     execute.is_ipv6 = false;
+    execute.builtin = true;
     expected.push_back(execute);
   }
   {  // Quit.
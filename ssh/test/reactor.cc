@@ -0,0 +1,133 @@
+/*
+ * Copyright 2020 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <functional>
+
+#include "com/centreon/connector/reactor.hh"
+#include "com/centreon/connector/ssh/notifier.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::connector;
+using namespace com::centreon::connector::ssh;
+
+/**
+ *  Listener counting its callbacks.
+ */
+class counting_listener : public handle_listener {
+ public:
+  unsigned int errors = 0;
+  unsigned int reads = 0;
+  unsigned int queries = 0;
+  bool wanted = true;
+  std::function<void()> on_read;
+
+  void error(handle& h) override { ++errors; }
+  void read(handle& h) override {
+    ++reads;
+    char buffer[8];
+    h.read(buffer, sizeof(buffer));
+    if (on_read)
+      on_read();
+  }
+  bool want_read(handle& h) override {
+    ++queries;
+    return wanted;
+  }
+};
+
+TEST(Reactor, CachedInterest) {
+  // Objects.
+  notifier active([]() {});
+  notifier idle([]() {});
+  counting_listener active_listnr;
+  counting_listener idle_listnr;
+  reactor r;
+  r.add(&active, &active_listnr);
+  r.add(&idle, &idle_listnr);
+
+  // Only the handle that got an event is queried again.
+  for (unsigned int i = 0; i < 3; ++i) {
+    active.notify();
+    r.multiplex();
+  }
+
+  // Checks.
+  ASSERT_EQ(active_listnr.reads, 3u);
+  ASSERT_EQ(active_listnr.queries, 3u);
+  ASSERT_EQ(idle_listnr.reads, 0u);
+  ASSERT_EQ(idle_listnr.queries, 1u);
+}
+
+TEST(Reactor, Update) {
+  // Objects.
+  notifier active([]() {});
+  notifier idle([]() {});
+  counting_listener active_listnr;
+  counting_listener idle_listnr;
+  idle_listnr.wanted = false;
+  reactor r;
+  r.add(&active, &active_listnr);
+  r.add(&idle, &idle_listnr);
+
+  // Not monitored for reading.
+  idle.notify();
+  active.notify();
+  r.multiplex();
+  ASSERT_EQ(idle_listnr.reads, 0u);
+
+  // Interest change is only seen after update().
+  idle_listnr.wanted = true;
+  active.notify();
+  r.multiplex();
+  ASSERT_EQ(idle_listnr.reads, 0u);
+  r.update(&idle);
+  active.notify();
+  r.multiplex();
+  ASSERT_EQ(idle_listnr.reads, 1u);
+}
+
+TEST(Reactor, RemoveDuringDispatch) {
+  // Objects.
+  notifier first([]() {});
+  notifier second([]() {});
+  counting_listener first_listnr;
+  counting_listener second_listnr;
+  reactor r;
+  r.add(&first, &first_listnr);
+  r.add(&second, &second_listnr);
+  first_listnr.on_read = [&r, &second]() {
+    r.remove(static_cast<handle*>(&second));
+  };
+  second_listnr.on_read = [&r, &first]() {
+    r.remove(static_cast<handle*>(&first));
+  };
+
+  // Both handles are ready, the first dispatched removes the other.
+  first.notify();
+  second.notify();
+  r.multiplex();
+
+  // Checks.
+  ASSERT_EQ(first_listnr.reads + second_listnr.reads, 1u);
+  ASSERT_EQ(r.remove(static_cast<handle*>(&first)) +
+                r.remove(static_cast<handle*>(&second)),
+            1);
+}
@@ -19,7 +19,13 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+
+#include "com/centreon/connector/ssh/sessions/agent_cache.hh"
+#include "com/centreon/connector/ssh/sessions/allocator.hh"
 #include "com/centreon/connector/ssh/sessions/credentials.hh"
+#include "com/centreon/connector/ssh/sessions/handshake_limiter.hh"
+#include "com/centreon/connector/ssh/sessions/token_bucket.hh"
 
 using namespace com::centreon::connector::ssh::sessions;
 
@@ -82,6 +88,7 @@ TEST(SSHSession, Default) {
   ASSERT_TRUE(creds.get_password().empty());
   ASSERT_EQ(creds.get_port(), 22);
   ASSERT_TRUE(creds.get_user().empty());
+  ASSERT_FALSE(creds.get_compress());
   ASSERT_EQ(creds, credentials());
   ASSERT_EQ(creds, credentials());
 }
@@ -127,6 +134,27 @@ TEST(SSHSession, LessThan) {
   ASSERT_FALSE(creds5 < creds1);
 }
 
+TEST(SSHSession, Compress) {
+  // Objects.
+  credentials creds1("localhost", "root", "random words");
+  credentials creds2(creds1);
+  creds2.set_compress(true);
+
+  // Compressed and uncompressed sessions must not be shared.
+  ASSERT_TRUE(creds2.get_compress());
+  ASSERT_NE(creds1, creds2);
+  ASSERT_NE(creds1.hash(), creds2.hash());
+  ASSERT_TRUE(creds1 < creds2);
+  ASSERT_FALSE(creds2 < creds1);
+
+  // Copies keep the flag.
+  credentials creds3;
+  creds3 = creds2;
+  ASSERT_EQ(creds3, creds2);
+  creds3.set_compress(false);
+  ASSERT_EQ(creds3, creds1);
+}
+
 TEST(SSHSession, Password) {
   // Object.
   com::centreon::connector::ssh::sessions::credentials creds;
@@ -156,3 +184,125 @@ TEST(SSHSession, User) {
   for (unsigned int i = 0; i < 1000; ++i)
     ASSERT_EQ(creds.get_user(), "Merethis");
 }
+
+TEST(SSHSession, TokenBucketUnlimited) {
+  // Object.
+  token_bucket tb;
+
+  // Checks.
+  ASSERT_FALSE(tb.is_limited());
+  for (unsigned int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(tb.wait_time(token_bucket::clock::now()).count(), 0);
+    tb.consume();
+  }
+}
+
+TEST(SSHSession, TokenBucketBurst) {
+  // Object.
+  token_bucket tb(2, 3);
+  token_bucket::clock::time_point now(token_bucket::clock::now());
+
+  // Checks.
+  ASSERT_TRUE(tb.is_limited());
+  ASSERT_TRUE(tb.is_full(now));
+  for (unsigned int i = 0; i < 3; ++i) {
+    ASSERT_EQ(tb.wait_time(now).count(), 0);
+    tb.consume();
+  }
+  ASSERT_EQ(tb.wait_time(now).count(), 500);
+  ASSERT_EQ(tb.wait_time(now + std::chrono::milliseconds(500)).count(), 0);
+  ASSERT_TRUE(tb.is_full(now + std::chrono::seconds(2)));
+}
+
+TEST(SSHSession, HandshakeLimiterPerHost) {
+  // Object.
+  handshake_limiter hl(0, 1);
+  std::chrono::milliseconds wait;
+
+  // Checks.
+  ASSERT_TRUE(hl.is_enabled());
+  ASSERT_TRUE(hl.acquire("host1", wait));
+  ASSERT_FALSE(hl.acquire("host1", wait));
+  ASSERT_GT(wait.count(), 0);
+  ASSERT_TRUE(hl.acquire("host2", wait));
+  ASSERT_FALSE(hl.is_saturated());
+}
+
+TEST(SSHSession, HandshakeLimiterGlobal) {
+  // Object.
+  handshake_limiter hl(2);
+  std::chrono::milliseconds wait;
+
+  // Checks.
+  ASSERT_TRUE(hl.acquire("host1", wait));
+  ASSERT_TRUE(hl.acquire("host2", wait));
+  ASSERT_FALSE(hl.acquire("host3", wait));
+  ASSERT_TRUE(hl.is_saturated());
+}
+
+TEST(SSHSession, AgentCache) {
+  // Objects.
+  agent_cache disabled;
+  agent_cache ac("/tmp/agent.sock");
+  credentials creds1("localhost", "root", "random words");
+  credentials creds2("localhost", "root", "other words", "/root/.ssh/id");
+  credentials creds3("localhost", "centreon", "random words");
+
+  // Checks.
+  ASSERT_FALSE(disabled.is_enabled());
+  ASSERT_TRUE(ac.is_enabled());
+  ASSERT_EQ(ac.get_socket_path(), "/tmp/agent.sock");
+  ASSERT_TRUE(ac.get_identity(creds1).empty());
+  ac.set_identity(creds1, std::string("\0blob", 5));
+  ASSERT_EQ(ac.get_identity(creds1), std::string("\0blob", 5));
+  ASSERT_EQ(ac.get_identity(creds2), std::string("\0blob", 5));
+  ASSERT_TRUE(ac.get_identity(creds3).empty());
+  ASSERT_EQ(ac.size(), 1u);
+  ac.forget(creds2);
+  ASSERT_TRUE(ac.get_identity(creds1).empty());
+  ASSERT_EQ(ac.size(), 0u);
+}
+
+TEST(SSHSession, Hash) {
+  // Objects.
+  credentials creds1("localhost", "root", "random words");
+  credentials creds2;
+  creds2.set_host("localhost");
+  creds2.set_user("root");
+  creds2.set_password("random words");
+  credentials creds3(creds1);
+  creds3.set_port(2222);
+
+  // Checks.
+  ASSERT_EQ(creds1.hash(), creds2.hash());
+  ASSERT_EQ(std::hash<credentials>()(creds1), creds1.hash());
+  ASSERT_NE(creds1.hash(), creds3.hash());
+  creds3.set_port(22);
+  ASSERT_EQ(creds1.hash(), creds3.hash());
+  ASSERT_EQ(creds1, creds3);
+}
+
+TEST(SSHSession, Allocator) {
+  // Objects.
+  size_t total(allocator::get_total_allocated());
+  allocator a;
+  void* small(a.allocate(10));
+  void* large(a.allocate(100000));
+  memset(small, 'a', 10);
+  ASSERT_EQ(a.get_allocated(), 100010u);
+  ASSERT_EQ(allocator::get_total_allocated(), total + 100010u);
+
+  // Reallocations keep data.
+  small = a.reallocate(small, 20);
+  small = a.reallocate(small, 5000);
+  ASSERT_EQ(static_cast<char*>(small)[9], 'a');
+  large = a.reallocate(large, 200000);
+  ASSERT_EQ(a.get_allocated(), 205000u);
+
+  // Checks.
+  a.deallocate(small);
+  a.deallocate(large);
+  ASSERT_EQ(a.get_allocated(), 0u);
+  ASSERT_EQ(a.get_peak(), 205000u);
+  ASSERT_EQ(allocator::get_total_allocated(), total);
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2020 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <vector>
+
+#include "com/centreon/connector/timer_wheel.hh"
+
+using namespace com::centreon::connector;
+
+/**
+ *  Timer running a callback.
+ */
+class callback_timer : public timer {
+ public:
+  std::function<void()> callback;
+
+  void run() override {
+    if (callback)
+      callback();
+  }
+};
+
+TEST(TimerWheel, Deadlines) {
+  // Objects, deadlines cover every level.
+  timer_wheel tw(0);
+  std::vector<uint64_t> deadlines{0,       1,        255,       256,
+                                  5000,    16384,    20000,     1048577,
+                                  7654321, 67108864, 123456789, 5000000000};
+  std::vector<callback_timer> timers(deadlines.size());
+  std::vector<uint64_t> fired(deadlines.size());
+  uint64_t now(0);
+  for (size_t i = 0; i < timers.size(); ++i) {
+    timers[i].callback = [&fired, &now, i]() { fired[i] = now; };
+    tw.add(timers[i], deadlines[i]);
+  }
+  ASSERT_EQ(tw.size(), deadlines.size());
+
+  // Sleep as long as the wheel allows.
+  long wait;
+  while ((wait = tw.next_timeout(now)) >= 0) {
+    now += wait;
+    tw.expire(now);
+  }
+
+  // Checks: each timer ran exactly at its deadline.
+  ASSERT_EQ(tw.size(), 0u);
+  for (size_t i = 0; i < timers.size(); ++i) {
+    ASSERT_FALSE(timers[i].is_armed());
+    ASSERT_EQ(fired[i], deadlines[i]);
+  }
+}
+
+TEST(TimerWheel, Cancel) {
+  // Objects.
+  timer_wheel tw(1000);
+  unsigned int runs(0);
+  callback_timer t1;
+  callback_timer t2;
+  t1.callback = [&runs]() { ++runs; };
+  t2.callback = [&runs]() { ++runs; };
+  tw.add(t1, 1500);
+  tw.add(t2, 1500);
+  {
+    callback_timer t3;
+    tw.add(t3, 1200);
+  }
+  ASSERT_EQ(tw.size(), 2u);
+
+  // Cancel and reschedule.
+  t1.cancel();
+  tw.add(t2, 1100);
+  ASSERT_FALSE(t1.is_armed());
+  ASSERT_TRUE(t2.is_armed());
+  ASSERT_EQ(tw.next_timeout(1000), 100);
+
+  // Checks.
+  ASSERT_EQ(tw.expire(1099), 0u);
+  ASSERT_EQ(tw.expire(2000), 1u);
+  ASSERT_EQ(runs, 1u);
+  ASSERT_EQ(tw.next_timeout(2000), -1);
+}
+
+TEST(TimerWheel, CancelWhileRunning) {
+  // Objects, expiring at the same time.
+  timer_wheel tw(0);
+  callback_timer t1;
+  callback_timer t2;
+  unsigned int runs(0);
+  t1.callback = [&]() {
+    ++runs;
+    t2.cancel();
+    tw.add(t1, 10);
+  };
+  t2.callback = [&]() {
+    ++runs;
+    t1.cancel();
+    tw.add(t2, 10);
+  };
+  tw.add(t1, 5);
+  tw.add(t2, 5);
+
+  // Checks: the first run timer cancels the other one and is rearmed.
+  ASSERT_EQ(tw.expire(5), 1u);
+  ASSERT_EQ(runs, 1u);
+  ASSERT_EQ(tw.size(), 1u);
+  ASSERT_EQ(tw.next_timeout(5), 5);
+}
+
+TEST(TimerWheel, PastDeadline) {
+  // Object.
+  timer_wheel tw(100);
+  callback_timer t;
+  tw.add(t, 50);
+
+  // Checks.
+  ASSERT_EQ(tw.next_timeout(100), 0);
+  ASSERT_EQ(tw.expire(100), 1u);
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2020 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "com/centreon/connector/mpsc_queue.hh"
+#include "com/centreon/connector/ssh/notifier.hh"
+
+using namespace com::centreon::connector;
+using namespace com::centreon::connector::ssh;
+
+TEST(SSHWorker, QueueOrder) {
+  // Object.
+  mpsc_queue<std::string> q;
+  ASSERT_TRUE(q.empty());
+  ASSERT_TRUE(q.push("first"));
+  ASSERT_FALSE(q.push("second"));
+  ASSERT_FALSE(q.push("third"));
+
+  // Checks.
+  std::vector<std::string> v;
+  ASSERT_EQ(q.consume([&v](std::string&& s) { v.push_back(std::move(s)); }),
+            3u);
+  ASSERT_TRUE(q.empty());
+  ASSERT_EQ(v, (std::vector<std::string>{"first", "second", "third"}));
+}
+
+TEST(SSHWorker, QueueProducers) {
+  // Object.
+  mpsc_queue<int> q;
+  std::vector<std::thread> producers;
+  for (int i = 0; i < 4; ++i)
+    producers.emplace_back([&q, i]() {
+      for (int j = 0; j < 1000; ++j)
+        q.push(i * 1000 + j);
+    });
+  for (auto& t : producers)
+    t.join();
+
+  // Checks: each producer's elements are consumed in order.
+  std::vector<int> last(4, -1);
+  size_t count(q.consume([&last](int&& value) {
+    ASSERT_GT(value % 1000, last[value / 1000]);
+    last[value / 1000] = value % 1000;
+  }));
+  ASSERT_EQ(count, 4000u);
+}
+
+TEST(SSHWorker, Notifier) {
+  // Object.
+  unsigned int calls(0);
+  notifier n([&calls]() { ++calls; });
+  n.notify();
+  n.notify();
+
+  // Checks.
+  ASSERT_TRUE(n.want_read(n));
+  ASSERT_FALSE(n.want_write(n));
+  n.read(n);
+  ASSERT_EQ(calls, 1u);
+  uint64_t value;
+  ASSERT_EQ(n.read(&value, sizeof(value)), 0u);
+}